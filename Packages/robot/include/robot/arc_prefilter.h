@@ -0,0 +1,75 @@
+/**
+ * @file arc_prefilter.h
+ * @brief Declares the prefilter that checks a laser scan for arcs before the
+ * circle detector runs on it
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef ARC_PREFILTER_H
+#define ARC_PREFILTER_H
+
+#include <vector>
+#include "detect_helpers.h"
+
+/**
+ * @brief Checks in a single pass over the ranges whether the scan contains a
+ * convex arc that could belong to a circle
+ *
+ * @details The scan is split into segments at range discontinuities. Inside
+ * a segment the points are smoothed and the curvature is computed from
+ * triples of beams whose spacing is adapted to the range, so the triple
+ * always spans about twice the smallest radius. A candidate is a run of triples that bulge towards the robot with a
+ * consistent radius within the expected range. Walls have no curvature and
+ * corners only curve over a few triples, so most maze scans are rejected.
+ *
+ * @param ranges The ranges from the laser range finder
+ * @param angle_min The angle of the first beam in radians
+ * @param angle_increment The angle between two beams in radians
+ * @param params The expected radius range and the discontinuity threshold
+ * @return Returns true if at least one candidate arc was found
+ */
+bool HasArcCandidate(const std::vector<float>& ranges, double angle_min,
+                     double angle_increment, const ArcParams& params);
+
+/**
+ * @brief Defines the ArcGate class which decides whether a scan goes to the
+ * circle detector when the detector also searches the previous scans.
+ *
+ * @details A scan without an arc still goes to the detector while one of the
+ * previous scans searched with it had one, as together they may show a
+ * circle the current scan is too sparse for. Scans after a run of walls
+ * only are skipped however many scans are searched.
+ *
+ * Usage:
+ *     if (!gate.Pass(HasArcCandidate(ranges, ...), scans)) { skip the scan }
+ */
+class ArcGate {
+private:
+    /**
+     * @brief Scans since the last one with an arc
+     */
+    int scans_since_arc_;
+
+public:
+    /**
+     * @brief Default constructor for ArcGate, which has seen no arc yet
+     */
+    ArcGate();
+
+    /**
+     * @brief Records the prefilter result of the current scan
+     *
+     * @param has_arc True if the prefilter found an arc in the current scan
+     * @param scans Number of scans searched together, the current one
+     * included
+     * @return Returns true if the scan has to go to the detector
+     */
+    bool Pass(bool has_arc, int scans);
+};
+
+#endif
@@ -15,11 +15,30 @@
 
 #include "ros/ros.h"
 #include "sensor_msgs/LaserScan.h"
+#include "nav_msgs/Odometry.h"
+#include "std_msgs/Bool.h"
+#include "robot/circle_candidate.h"
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include "detect_helpers.h"
+#include "detection_frame.h"
+#include "spsc_queue.h"
+#include "point_hough.h"
+#include "polar_matcher.h"
+#include "split_hough.h"
+#include "deadline.h"
+#include "load_governor.h"
+#include "circle_fit.h"
+#include "circle_tracker.h"
+#include "local_point_map.h"
+#include "pose_helpers.h"
+#include "scan_deskew.h"
+#include "arc_prefilter.h"
 
 using namespace std;
 using namespace cv;
@@ -51,6 +70,17 @@ private:
 
     ros::Subscriber laser_sub_;
 
+    /**
+     * @brief Subscriber to the odometry of the robot, used to predict where
+     * the tracked circle moves
+     */
+    ros::Subscriber odom_sub_;
+
+    /**
+     * @brief Subscriber to the controller telling whether it needs detections
+     */
+    ros::Subscriber demand_sub_;
+
     /**
     * @brief the circle_detect_pub publishes the translated lrf input as well as circles, if any.
     */
@@ -62,31 +92,582 @@ private:
      */
     BlurParams blur_params_;
 
+    /**
+     * @brief Blurred footprint of a single laser point
+     */
+    cv::Mat splat_kernel_;
+
+    /**
+     * @brief The blur sigma splat_kernel_ was computed with
+     */
+    double splat_sigma_;
+
     /**
      * @brief Parameters for the Hough Circles
      */
     HoughParams hough_params_;
 
     /**
-     * @brief Load the parameters from the rosparam space
+     * @brief How the Hough transform is split into parallel jobs
+     */
+    SplitParams split_params_;
+
+    /**
+     * @brief Parameters for the image the scan is drawn on
+     */
+    RasterParams raster_params_;
+
+    /**
+     * @brief Parameters for the prefilter that skips scans without arcs
+     */
+    ArcParams arc_params_;
+
+    /**
+     * @brief Lets scans without arcs through while the previous scans
+     * searched with them had one
+     */
+    ArcGate arc_gate_;
+
+    /**
+     * @brief Number of Gauss-Newton iterations used to refine a circle
+     */
+    int fit_iterations_;
+
+    /**
+     * @brief The algorithm used to find the circles
+     */
+    DetectorBackend backend_;
+
+    /**
+     * @brief Sparse Hough transform used by the POINT_VOTE backend
+     */
+    PointHough point_hough_;
+
+    /**
+     * @brief Range profile matcher used by the POLAR_TEMPLATE backend
+     */
+    PolarMatcher polar_matcher_;
+
+    /**
+     * @brief Maximum root mean square error of a polar template match in
+     * metres
+     */
+    double polar_max_error_;
+
+    /**
+     * @brief Time budget in seconds for the detection of one scan, 0 for no
+     * limit
+     */
+    double detection_budget_;
+
+    /**
+     * @brief Parameters for the governor that sheds load under overload
+     */
+    GovernorParams governor_params_;
+
+    /**
+     * @brief Picks the degradation level. Only used by the detection stage
+     */
+    LoadGovernor governor_;
+
+    /**
+     * @brief The level the next frame is prepared at, written by the
+     * detection stage and read by the rasterisation stage
+     */
+    std::atomic<int> load_level_;
+
+    /**
+     * @brief Number of scans seen while frames are skipped
+     */
+    int skip_count_;
+
+    /**
+     * @brief False while the controller has no use for detections
+     */
+    std::atomic<bool> demanded_;
+
+    /**
+     * @brief While idle only every idle_scan_stride_-th scan is detected, 0
+     * for none
+     */
+    int idle_scan_stride_;
+
+    /**
+     * @brief Number of scans seen while idle
+     */
+    int idle_count_;
+
+    /**
+     * @brief Scans per second that are detected at most, 0 for every scan
+     */
+    double detection_rate_;
+
+    /**
+     * @brief Time stamp of the last scan let through by ThrottleScan
+     */
+    ros::Time last_detected_stamp_;
+
+    /**
+     * @brief Parameters for the tracker that follows the circle between scans
+     */
+    TrackParams track_params_;
+
+    /**
+     * @brief The tracker after the last detected scan. Written by the
+     * detection stage under track_mutex_
+     */
+    TrackState track_state_;
+
+    /**
+     * @brief Guards track_state_ while the rasterisation stage reads it
+     */
+    std::mutex track_mutex_;
+
+    /**
+     * @brief Latest pose from the odometry
+     */
+    Pose2D odom_pose_;
+
+    /**
+     * @brief True once an odometry message has been received
+     */
+    bool have_odometry_;
+
+    /**
+     * @brief Latest forward and turn velocity from the odometry
+     */
+    double odom_linear_velocity_, odom_angular_velocity_;
+
+    /**
+     * @brief True if the scans are corrected for the motion of the robot
+     * during the sweep before they are used
+     */
+    bool deskew_scans_;
+
+    /**
+     * @brief Distance of the LRF in front of the centre the robot turns
+     * around, in metres
+     */
+    double laser_offset_;
+
+    /**
+     * @brief Corrects the scans if deskew_scans_ is set
+     */
+    ScanDeskewer deskewer_;
+
+    /**
+     * @brief Number of scans, including the current one, that are searched
+     * together
+     */
+    int local_map_scans_;
+
+    /**
+     * @brief Points of the previous scans
+     */
+    LocalPointMap local_map_;
+
+    /**
+     * @brief True if rasterisation and detection run on two threads of
+     * their own
+     */
+    bool pipelined_;
+
+    /**
+     * @brief The two frames the stages pass between them, one being
+     * rasterised while the other is detected
+     */
+    std::vector<DetectionFrame> frames_;
+
+    /**
+     * @brief Rasterised frames waiting for the detection stage
+     */
+    SpscQueue<DetectionFrame*> ready_frames_;
+
+    /**
+     * @brief Detected frames handed back to the rasterisation stage
+     */
+    SpscQueue<DetectionFrame*> free_frames_;
+
+    /**
+     * @brief The latest scan not yet taken by the rasterisation stage, empty
+     * if there is none. Older scans are overwritten
+     */
+    sensor_msgs::LaserScan::ConstPtr latest_scan_;
+
+    /**
+     * @brief Odometry pose of latest_scan_
+     */
+    Pose2D latest_pose_;
+
+    /**
+     * @brief True if latest_pose_ comes from the odometry
+     */
+    bool latest_have_odometry_;
+
+    /**
+     * @brief Guards latest_scan_ and its pose
+     */
+    std::mutex scan_mutex_;
+
+    /**
+     * @brief Cleared to stop the pipeline threads
+     */
+    std::atomic<bool> running_;
+
+    /**
+     * @brief Runs RasterLoop in pipelined mode
+     */
+    std::thread raster_thread_;
+
+    /**
+     * @brief Runs DetectLoop in pipelined mode
+     */
+    std::thread detect_thread_;
+
+    /**
+     * @brief Load the parameters from the rosparam space, once at start-up
      */
     void LoadParams();
 
     void LoadTopics();
 
     /**
-     * @brief [brief description]
+     * @brief Starts the pipeline threads if pipelined mode is configured
+     */
+    void StartPipeline();
+
+    /**
+     * @brief Takes the latest scan and rasterises it whenever a frame is
+     * free, until running_ is cleared
+     */
+    void RasterLoop();
+
+    /**
+     * @brief Detects the newest rasterised frame, skipping older ones, until
+     * running_ is cleared
+     */
+    void DetectLoop();
+
+    /**
+     * @brief The rasterisation stage. Picks the bands to search and draws
+     * them
+     *
+     * @param frame The frame with the scan and its pose set, filled with the
+     * bands
+     */
+    void PrepareFrame(DetectionFrame& frame);
+
+    /**
+     * @brief The detection stage. Searches the bands of the frame, updates
+     * the tracker and publishes the circles
+     *
+     * @param frame A frame filled by PrepareFrame
+     */
+    void DetectFrame(DetectionFrame& frame);
+
+    /**
+     * @brief Moves a tracker from the scan of a track state to the scan of
+     * a frame, or resets it if tracking is disabled
+     *
+     * @param state The state the tracker was taken from
+     * @param frame The frame to predict the tracker for
+     * @param tracker The tracker to move
+     * @return The time in seconds between the two scans
+     */
+    double PredictTrack(const TrackState& state, const DetectionFrame& frame,
+                        CircleTracker& tracker);
+
+    /**
+     * @brief Picks the pixel scale, the range and the image size for a range
+     * band. In adaptive mode the coarse scale is used until a circle is seen
+     * within the fine range
+     *
+     * @param band The range band, 0 is the closest
+     * @param circle_distance Distance to the last detected circle in metres,
+     * -1 if there was none
+     * @param coarse Halves the scale to shed load
+     * @param view Filled with the view of the band, searching the whole image
+     * with the configured backend and radius range
+     */
+    void SelectResolution(int band, double circle_distance, bool coarse, BandView& view);
+
+    /**
+     * @brief Decides whether a scan is left out to shed load. While frames
+     * are skipped every second scan is left out
+     *
+     * @return Returns true if the scan is not to be detected
+     */
+    bool SkipScan();
+
+    /**
+     * @brief Decides whether a scan is left out because nobody needs the
+     * detections. While idle a scan is only detected every
+     * idle_scan_stride_ scans
+     *
+     * @return Returns true if the scan is not to be detected
+     */
+    bool IdleScan();
+
+    /**
+     * @brief Corrects a scan for the motion of the robot with the twist from
+     * the odometry
+     *
+     * @return The corrected scan, stamped with the end of the sweep it is
+     * seen from, or the scan itself if deskew_scans_ is not set, there is no
+     * odometry or the robot stands still
+     */
+    sensor_msgs::LaserScan::ConstPtr DeskewScan(const sensor_msgs::LaserScan::ConstPtr& msg);
+
+    /**
+     * @brief Decides whether a scan is left out to keep to detection_rate_
+     *
+     * @param msg The scan
+     * @return Returns true if the scan came too soon after the last one
+     */
+    bool ThrottleScan(const sensor_msgs::LaserScan::ConstPtr& msg);
+
+    /**
+     * @brief Hands the processing time of a frame to the governor and sets
+     * the level for the next frame
+     *
+     * @param frame The detected frame
+     * @param dt Time in seconds since the previous detected scan
+     * @param detect_time Time in seconds the detection stage took
+     */
+    void GovernLoad(const DetectionFrame& frame, double dt, double detect_time);
+
+    /**
+     * @brief Range in metres up to which a band reaches
+     */
+    double BandMaxRange(int band);
+
+    /**
+     * @brief The band a circle at the given distance in metres is searched in
+     */
+    int BandOf(double distance);
+
+    /**
+     * @brief Draws a band for the detection stage
+     *
+     * @param msg Raw data coming from the laser range finder
+     * @param history The points of the previous scans
+     * @param tracker The tracker predicted for the scan
+     * @param raster The band with its view set, filled with the scan, the
+     * points and the image
+     */
+    void PrepareBand(const sensor_msgs::LaserScan::ConstPtr& msg,
+                     const std::vector<cv::Point2f>& history,
+                     const CircleTracker& tracker, BandRaster& raster);
+
+    /**
+     * @brief Finds the circles in a band drawn by PrepareBand
+     *
+     * @param raster The band to search
+     * @param deadline When the backend has to stop searching
+     * @param candidates The refined circles in metres are added to it, unless
+     * a circle from a previous band is at the same place
+     * @return Returns false if the search was cut short by the deadline
+     */
+    bool DetectInBand(BandRaster& raster, const Deadline& deadline,
+                      std::vector<CircleFit>& candidates);
+
+    /**
+     * @brief Converts the Hough parameters, which are given at the fine
+     * scale, to the scale of a band
+     *
+     * @param view The view of the band
+     * @return The Hough parameters for the band
+     */
+    HoughParams ScaledHoughParams(const BandView& view);
+
+    /**
+     * @brief Restricts the search to the area around the predicted circle
+     * once the track is locked
      *
-     * @return [description]
+     * @details Beams that cannot hit the area are set to infinity, so every
+     * backend skips them, and the window of the view is cut to the part of
+     * the image around the prediction. Without a locked track, and in the
+     * full searches of a locked one, the scan is returned as is.
+     *
+     * @param msg Raw data coming from the laser range finder
+     * @param tracker The tracker predicted for the scan
+     * @param view The view of the band
+     * @return The scan to search
+     */
+    sensor_msgs::LaserScan::ConstPtr RestrictToTrack(const sensor_msgs::LaserScan::ConstPtr& msg,
+                                                     const CircleTracker& tracker,
+                                                     BandView& view);
+
+    /**
+     * @brief Draws the laser scan on an image. Every point is drawn with the
+     * footprint the Gaussian blur would give it, so no separate blur of the
+     * whole image is needed
+     *
+     * @param msg Raw data coming from the laser range finder
+     * @param view The view of the band
+     * @param image Filled with the blurred image of the scan, reusing its memory
+     */
+    void CreateImage(const sensor_msgs::LaserScan::ConstPtr& msg, const BandView& view,
+                     cv::Mat& image);
+
+    /**
+     * @brief Recomputes splat_kernel_ if the blur parameters have changed
+     *
+     * @param view The view of the band the kernel is used for
+     */
+    void UpdateSplatKernel(const BandView& view);
+
+    /**
+     * @brief Adds the footprint of a single point to the image
+     *
+     * @param image The image to draw on
+     * @param x The x screen coordinate of the point
+     * @param y The y screen coordinate of the point
+     */
+    void SplatPoint(cv::Mat& image, int x, int y);
+
+    /**
+     * @brief Adds the footprints of points in metres to the image
+     *
+     * @param image The image to draw on
+     * @param points The Cartesian points in metres
+     * @param view The view of the band
+     */
+    void SplatPoints(cv::Mat& image, const std::vector<cv::Point2f>& points,
+                     const BandView& view);
+
+    /**
+     * @brief Stores the scan in the local map and returns the points of the
+     * previous scans, moved to the pose of the scan with the odometry
+     *
+     * @param frame The frame with the scan and its pose
+     * @param history Filled with the points of the previous scans
+     */
+    void UpdateLocalMap(const DetectionFrame& frame, std::vector<cv::Point2f>& history);
+
+    /**
+     * @brief Picks the points of the previous scans that lie within the
+     * band and search window of a view
+     *
+     * @param history The points of the previous scans
+     * @param view The view of the band
+     * @param selected Filled with the picked points
+     */
+    void SelectHistory(const std::vector<cv::Point2f>& history, const BandView& view,
+                       std::vector<cv::Point2f>& selected);
+
+    /**
+     * @brief Converts the laser scan to Cartesian points in metres without
+     * building an image
+     *
+     * @param msg Raw data coming from the laser range finder
+     * @param min_range Closer beams are left out
+     * @param max_range Beams at least this far are left out
+     * @param points Filled with the points in scan order
+     */
+    void CreatePoints(const sensor_msgs::LaserScan::ConstPtr& msg,
+                      double min_range, double max_range,
+                      std::vector<cv::Point2f>& points);
+
+    /**
+     * @brief Finds the circles with the Hough gradient transform. A single
+     * transform cannot be interrupted, so the deadline is only checked
+     * between the jobs of a split transform
+     *
+     * @param image The blurred image of the band
+     * @param view The view of the band
+     * @param deadline When to stop starting new jobs
+     * @param complete Set to false if jobs were skipped because of the deadline
+     * @return The circles in screen coordinates
      */
-    cv::Mat CreateImage(const sensor_msgs::LaserScan::ConstPtr& msg);
+    vector<Vec3f> FindCircles(cv::Mat& image, const BandView& view,
+                              const Deadline& deadline, bool& complete);
 
-    vector<Vec3f> FindCircles(cv::Mat& image);
+    /**
+     * @brief Finds the circles by letting the points vote directly
+     *
+     * @param points The Cartesian points in metres and scan order
+     * @param view The view of the band
+     * @param deadline When to stop voting
+     * @param complete Set to false if radii were skipped because of the deadline
+     * @return The circles in the same format as FindCircles
+     */
+    vector<Vec3f> VoteCircles(std::vector<cv::Point2f>& points, const BandView& view,
+                              const Deadline& deadline, bool& complete);
 
-    void TransformCircle(double& circle_x, double& circle_y,
-                         cv::Mat& image, std::vector<Vec3f>& circles);
+    /**
+     * @brief Finds the circles by matching templates against the range
+     * profile of the scan
+     *
+     * @param msg Raw data coming from the laser range finder
+     * @param view The view of the band
+     * @param deadline When to stop matching
+     * @param complete Set to false if beams were skipped because of the deadline
+     * @return The circles in the same format as FindCircles
+     */
+    vector<Vec3f> MatchCircles(const sensor_msgs::LaserScan::ConstPtr& msg,
+                               const BandView& view, const Deadline& deadline,
+                               bool& complete);
 
-    void PublishCircle(double circle_x, double circle_y,
+    /**
+     * @brief Converts the circles from screen coordinates to metres and
+     * refines them
+     *
+     * @param circles The circles in screen coordinates
+     * @param points The Cartesian points in metres
+     * @param view The view of the band
+     * @param candidates Filled with the refined circles in metres
+     */
+    void TransformCircles(std::vector<Vec3f>& circles, std::vector<cv::Point2f>& points,
+                          const BandView& view, std::vector<CircleFit>& candidates);
+
+    /**
+     * @brief Refines the circle below the pixel size by fitting a circle
+     * through the scan points close to it, in metric coordinates
+     *
+     * @details The algebraic fit gives the starting point for a few
+     * Gauss-Newton iterations of the geometric fit, which also yields the
+     * residual of the fit. The circle is left as is if the fit fails.
+     *
+     * @param circle The circle found by the Hough transform in metres, refined
+     * in place
+     * @param points The Cartesian points in metres
+     * @param view The view of the band the circle was found in
+     */
+    void RefineCircle(CircleFit& circle, std::vector<cv::Point2f>& points,
+                      const BandView& view);
+
+    /**
+     * @brief Converts a laser beam to Cartesian coordinates at a given scale
+     *
+     * @param x is set to the x coordinate in pixels
+     * @param y is set to the y coordinate in pixels
+     * @param range is the range of the beam
+     * @param angle is the angle of the beam
+     * @param scale is the number of pixels per metre
+     */
+    void ConvertLaserScanToCartesian(int &x, int &y, float range, float angle, double scale);
+
+    /**
+     * @brief Publishes the circle and the candidates of the scan
+     *
+     * @param circle_x The x coordinate of the circle in metres, -10 if none
+     * @param circle_y The y coordinate of the circle in metres, -10 if none
+     * @param radius The radius of the circle in metres
+     * @param residual The residual of the fit, -1 if no fit was made
+     * @param track_age The number of scans the circle has been tracked for
+     * @param track_confidence How much the circle can be trusted
+     * @param candidates All circles found in the scan
+     * @param complete False if the detection ran out of time and the circles
+     * are the best found until then
+     * @param load_level The degradation level the scan was detected at
+     * @param stamp Time stamp of the scan the circles were seen in
+     * @param ranges Raw ranges of the laser range finder
+     */
+    void PublishCircle(double circle_x, double circle_y, double radius,
+                       double residual, int track_age, double track_confidence,
+                       std::vector<robot::circle_candidate>& candidates,
+                       bool complete, int load_level, const ros::Time& stamp,
                        std::vector<float>& ranges);
 
 public:
@@ -96,14 +677,34 @@ public:
      */
     CircleDetector();
 
+    /**
+     * @brief Stops the pipeline threads, if running
+     */
+    ~CircleDetector();
+
     /**
      * @brief Gets the data from the laser range finder, creates an
-     * image out of it and runs openCV HoughLines on it
+     * image out of it and runs openCV HoughLines on it. In pipelined mode the
+     * scan is only handed to the rasterisation thread
      *
      * @param[in]  msg   msg Raw data comming from the laser range finder
      */
     void LaserCallback(const sensor_msgs::LaserScan::ConstPtr& msg);
 
+    /**
+     * @brief Stores the latest pose of the robot from the odometry
+     *
+     * @param msg The odometry message
+     */
+    void OdomCallback(const nav_msgs::Odometry::ConstPtr& msg);
+
+    /**
+     * @brief Stores whether the controller needs detections
+     *
+     * @param msg True if detections are needed
+     */
+    void DemandCallback(const std_msgs::Bool::ConstPtr& msg);
+
 
     /**
      * @brief Takes the Cartesian coordinates and converts them to
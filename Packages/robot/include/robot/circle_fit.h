@@ -0,0 +1,94 @@
+/**
+ * @file circle_fit.h
+ * @brief Declares least-squares circle fitting functions used to refine the
+ * circles found by the circle detector
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef CIRCLE_FIT_H
+#define CIRCLE_FIT_H
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+
+/**
+ * @brief Defines the CircleFit structure which holds a fitted circle
+ */
+struct CircleFit {
+    /**
+     * @brief The centre of the circle
+     */
+    cv::Point2f centre_;
+
+    /**
+     * @brief The radius of the circle
+     */
+    float radius_;
+
+    /**
+     * @brief Root mean square distance of the points from the circle
+     */
+    float residual_;
+};
+
+/**
+ * @brief Selects the points that lie close to a circle
+ *
+ * @param points The points to select from
+ * @param centre The centre of the circle
+ * @param radius The radius of the circle
+ * @param tolerance Maximum distance of a selected point from the circle
+ * @param selected Filled with the selected points
+ */
+void SelectCirclePoints(const std::vector<cv::Point2f>& points, const cv::Point2f& centre,
+                        float radius, float tolerance, std::vector<cv::Point2f>& selected);
+
+/**
+ * @brief Fits a circle through the points by algebraic least squares
+ *
+ * @param points The points on the circle, at least 3
+ * @param centre Filled with the centre of the fitted circle
+ * @param radius Filled with the radius of the fitted circle
+ * @return Returns false if there are too few points or they are collinear
+ */
+bool FitCircleAlgebraic(const std::vector<cv::Point2f>& points, cv::Point2f& centre,
+                        float& radius);
+
+/**
+ * @brief Fits a circle through the points by minimising the geometric
+ * distance of the points from the circle with Gauss-Newton iterations
+ *
+ * @param points The points on the circle, at least 3
+ * @param fit The initial guess, replaced by the fitted circle and its residual
+ * @param iterations Maximum number of Gauss-Newton iterations
+ * @return Returns false if there are too few points or the iterations
+ * diverge, in which case fit is left unchanged
+ */
+bool FitCircleGeometric(const std::vector<cv::Point2f>& points, CircleFit& fit,
+                        int iterations);
+
+/**
+ * @brief Scores how much a circle can be trusted from how well it was fitted
+ *
+ * @param fit The circle, with a negative residual if no fit was made
+ * @param tolerance The residual in metres that halves the score
+ * @return A value in (0, 1], 1 for a perfect fit. Circles that could not be
+ * fitted get a fixed low score
+ */
+float FitConfidence(const CircleFit& fit, float tolerance);
+
+/**
+ * @brief Picks the circle that can be trusted most, the fitted ones before
+ * the others and among them the one with the lowest residual
+ *
+ * @param circles The circles to pick from
+ * @return The index of the picked circle, or -1 if there is none
+ */
+int MostConfident(const std::vector<CircleFit>& circles);
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file circle_tracker.h
+ * @brief Header file for the tracker that follows the circle between scans.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef CIRCLE_TRACKER_H
+#define CIRCLE_TRACKER_H
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "circle_fit.h"
+#include "detect_helpers.h"
+#include "pose_helpers.h"
+
+/**
+ * @brief Defines the CircleTracker class which keeps a single circle
+ * hypothesis from scan to scan.
+ *
+ * @details The centre is filtered with an alpha-beta filter in the frame of
+ * the circle detector (x to the right, y forward, in metres). Before every
+ * scan the hypothesis is moved by the motion of the robot, when odometry is
+ * available, and by its own velocity, which absorbs the motion of the robot
+ * otherwise. Detections further than the gate from the prediction are
+ * ignored. The track is locked after a few detections and dropped after too
+ * many scans in a row without one. A locked track only has the window around
+ * the prediction searched, except for a full search every few scans, so a
+ * track on a wrong circle does not hide the others for as long as it lasts.
+ *
+ * Usage:
+ *     tracker.Predict(dt, motion);
+ *     tracker.Update(candidates, dt);
+ *     if (tracker.Active()) { ... tracker.Position() ... }
+ */
+class CircleTracker {
+private:
+    /**
+     * @brief Parameters of the tracker
+     */
+    TrackParams params_;
+
+    /**
+     * @brief True while there is a circle hypothesis
+     */
+    bool active_;
+
+    /**
+     * @brief Filtered centre of the circle in metres
+     */
+    cv::Point2f position_;
+
+    /**
+     * @brief Filtered velocity of the centre in metres per second
+     */
+    cv::Point2f velocity_;
+
+    /**
+     * @brief Filtered radius in metres
+     */
+    float radius_;
+
+    /**
+     * @brief Number of scans since the track was started
+     */
+    int age_;
+
+    /**
+     * @brief Number of detections that belonged to the track
+     */
+    int hits_;
+
+    /**
+     * @brief Number of scans in a row without a detection
+     */
+    int misses_;
+
+public:
+    /**
+     * @brief Default constructor for CircleTracker
+     */
+    CircleTracker();
+
+    /**
+     * @brief Sets the parameters of the tracker
+     */
+    void SetParams(const TrackParams& params);
+
+    /**
+     * @brief Drops the current hypothesis
+     */
+    void Reset();
+
+    /**
+     * @brief Moves the hypothesis to where the circle should be in the next
+     * scan
+     *
+     * @param dt Time since the previous scan in seconds
+     * @param motion Motion of the LRF since the previous scan in the ROS
+     * convention, as returned by LaserMotion
+     */
+    void Predict(double dt, const Pose2D& motion);
+
+    /**
+     * @brief Corrects the hypothesis with the detections of a scan
+     *
+     * @details Without a hypothesis, a new track is started from the
+     * detection with the best fit.
+     *
+     * @param candidates The detected circles in metres
+     * @param dt Time since the previous scan in seconds
+     * @return Returns the index of the detection that was used, or -1
+     */
+    int Update(const std::vector<CircleFit>& candidates, double dt);
+
+    /**
+     * @brief True while there is a circle hypothesis
+     */
+    bool Active() const;
+
+    /**
+     * @brief True once the track had enough detections to restrict the search
+     * to the area around the prediction
+     */
+    bool Locked() const;
+
+    /**
+     * @brief True if the next scan is only searched in the window around the
+     * prediction, which is the case for a locked track except every
+     * full_search_frames_ scans
+     */
+    bool Windowed() const;
+
+    /**
+     * @brief Filtered centre of the circle in metres
+     */
+    cv::Point2f Position() const;
+
+    /**
+     * @brief Filtered radius of the circle in metres
+     */
+    float Radius() const;
+
+    /**
+     * @brief Number of scans since the track was started
+     */
+    int Age() const;
+
+    /**
+     * @brief Confidence in the hypothesis between 0 and 1, growing with the
+     * detections up to the lock and shrinking with the misses
+     */
+    double Confidence() const;
+};
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file deadline.h
+ * @brief Point in time after which an anytime computation has to stop.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <opencv2/core/core.hpp>
+
+/**
+ * @brief Defines the Deadline class which tells an anytime computation when
+ * its time budget is used up.
+ *
+ * @details The computation checks Expired() between independent pieces of
+ * work and keeps what it has found so far once it returns true. The clock is
+ * the OpenCV tick counter, which is monotonic and cheap to read. A default
+ * constructed deadline never expires.
+ *
+ * Usage:
+ *     Deadline deadline(0.02);
+ *     while (work left && !deadline.Expired()) { do a piece of work }
+ */
+class Deadline {
+private:
+    /**
+     * @brief Tick count at which the budget ends, 0 for no limit
+     */
+    int64 end_;
+
+public:
+    /**
+     * @brief Creates a deadline that never expires
+     */
+    Deadline() : end_(0) {
+    }
+
+    /**
+     * @brief Creates a deadline that expires after the budget
+     *
+     * @param budget The time budget from now on in seconds. A budget of 0 or
+     * less means no limit
+     */
+    explicit Deadline(double budget) : end_(0) {
+        if (budget > 0) {
+            end_ = cv::getTickCount() + static_cast<int64>(budget * cv::getTickFrequency());
+        }
+    }
+
+    /**
+     * @brief Returns true if the budget is used up
+     */
+    bool Expired() const {
+        return end_ != 0 && cv::getTickCount() >= end_;
+    }
+};
+
+#endif
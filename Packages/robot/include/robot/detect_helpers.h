@@ -12,6 +12,14 @@
 #ifndef DETECT_HELPERS_H
 #define DETECT_HELPERS_H
 
+/**
+ * @brief Defines the algorithm used to find circles where
+ * HOUGH_GRADIENT=0, POINT_VOTE=1, POLAR_TEMPLATE=2
+ */
+enum DetectorBackend {
+	HOUGH_GRADIENT, POINT_VOTE, POLAR_TEMPLATE
+};
+
 /**
  * @brief Defines the BlurParams structure
  * which has two variables
@@ -67,4 +75,189 @@ struct HoughParams {
 	int max_radius_;
 };
 
+/**
+ * @brief Defines the SplitParams structure which describes how the Hough
+ * transform is split into jobs that run in parallel
+ */
+struct SplitParams {
+
+	/**
+	 * @brief radius_splits_ is the number of parts the radius range is split
+	 * into
+	 */
+	int radius_splits_;
+
+	/**
+	 * @brief tiles_ is the number of tiles along each side of the image
+	 */
+	int tiles_;
+};
+
+/**
+ * @brief Defines the RasterParams structure which describes the image the
+ * laser scan is drawn on
+ */
+struct RasterParams {
+
+	/**
+	 * @brief scale_factor_ is the number of pixels per metre. The blur and
+	 * Hough parameters are given at this scale
+	 */
+	double scale_factor_;
+
+	/**
+	 * @brief max_range_ is the distance in metres beyond which points are
+	 * ignored, or the range of the first band if there are several
+	 */
+	double max_range_;
+
+	/**
+	 * @brief bands_ is the number of range bands. Every further band reaches
+	 * twice as far as the previous one at half the scale, so all bands use an
+	 * image of the same size
+	 */
+	int bands_;
+
+	/**
+	 * @brief adaptive_ enables switching to the coarse scale while no circle
+	 * is close
+	 */
+	bool adaptive_;
+
+	/**
+	 * @brief coarse_scale_factor_ is the number of pixels per metre used when
+	 * no circle is close
+	 */
+	double coarse_scale_factor_;
+
+	/**
+	 * @brief fine_range_ is the distance in metres to a detected circle below
+	 * which the fine scale is used
+	 */
+	double fine_range_;
+};
+
+/**
+ * @brief Defines the ArcParams structure which configures the prefilter that
+ * skips scans without circle candidates
+ */
+struct ArcParams {
+
+	/**
+	 * @brief enabled_ runs the prefilter before the circle detector
+	 */
+	bool enabled_;
+
+	/**
+	 * @brief min_radius_ is the smallest arc radius in metres that is a candidate
+	 */
+	double min_radius_;
+
+	/**
+	 * @brief max_radius_ is the largest arc radius in metres that is a candidate
+	 */
+	double max_radius_;
+
+	/**
+	 * @brief jump_distance_ is the range difference in metres between two
+	 * neighbouring beams that splits the scan into separate objects
+	 */
+	double jump_distance_;
+
+	/**
+	 * @brief max_range_ is the distance in metres beyond which beams are ignored
+	 */
+	double max_range_;
+};
+
+/**
+ * @brief Defines the TrackParams structure which configures the tracker that
+ * follows the circle from scan to scan
+ */
+struct TrackParams {
+
+	/**
+	 * @brief enabled_ keeps the circle between scans and searches around its
+	 * predicted position
+	 */
+	bool enabled_;
+
+	/**
+	 * @brief alpha_ is the share of the position error that corrects the position
+	 */
+	double alpha_;
+
+	/**
+	 * @brief beta_ is the share of the position error that corrects the velocity
+	 */
+	double beta_;
+
+	/**
+	 * @brief gate_ is the largest distance in metres between the predicted
+	 * and the detected centre for the detection to belong to the track
+	 */
+	double gate_;
+
+	/**
+	 * @brief window_ is the distance in metres around the predicted circle
+	 * that is searched once the track is locked
+	 */
+	double window_;
+
+	/**
+	 * @brief lock_hits_ is the number of detections after which the track is
+	 * locked
+	 */
+	int lock_hits_;
+
+	/**
+	 * @brief max_misses_ is the number of scans in a row without a detection
+	 * after which the track is dropped
+	 */
+	int max_misses_;
+
+	/**
+	 * @brief full_search_frames_ is the number of scans after which a locked
+	 * track has the whole scan searched once, so circles outside the window
+	 * are found as well. 0 searches the window only
+	 */
+	int full_search_frames_;
+};
+
+/**
+ * @brief Defines the GovernorParams structure which configures how the
+ * detector sheds load when it cannot keep up with the scans
+ */
+struct GovernorParams {
+
+	/**
+	 * @brief enabled_ lets the governor degrade the detection under overload
+	 */
+	bool enabled_;
+
+	/**
+	 * @brief overload_ is the share of the scan period above which the
+	 * processing time counts as overload
+	 */
+	double overload_;
+
+	/**
+	 * @brief headroom_ is the share of the scan period below which the
+	 * processing time leaves room for a better level
+	 */
+	double headroom_;
+
+	/**
+	 * @brief smoothing_ is the weight of the newest frame in the averaged load
+	 */
+	double smoothing_;
+
+	/**
+	 * @brief hold_frames_ is the number of frames the load is only watched
+	 * after a change of level, and the number of frames in a row it has to
+	 * stay below headroom_ to step back up
+	 */
+	int hold_frames_;
+};
+
 #endif
@@ -0,0 +1,179 @@
+/**
+ * @file detection_frame.h
+ * @brief Data passed between the rasterisation and the detection stage of
+ * the circle detector.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef DETECTION_FRAME_H
+#define DETECTION_FRAME_H
+
+#include "ros/ros.h"
+#include "sensor_msgs/LaserScan.h"
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "circle_tracker.h"
+#include "detect_helpers.h"
+#include "pose_helpers.h"
+
+/**
+ * @brief Defines the BandView structure which describes how a range band is
+ * drawn on the image and searched
+ */
+struct BandView {
+
+	/**
+	 * @brief band_ is the range band, 0 is the closest
+	 */
+	int band_;
+
+	/**
+	 * @brief scale_ is the number of pixels per metre
+	 */
+	double scale_;
+
+	/**
+	 * @brief screen_ is the size of the image
+	 */
+	cv::Size screen_;
+
+	/**
+	 * @brief min_range_ is the distance in metres below which beams are not
+	 * drawn
+	 */
+	double min_range_;
+
+	/**
+	 * @brief max_range_ is the distance in metres from which on beams are not
+	 * drawn
+	 */
+	double max_range_;
+
+	/**
+	 * @brief window_ is the part of the image that is searched
+	 */
+	cv::Rect window_;
+
+	/**
+	 * @brief backend_ is the algorithm the band is searched with
+	 */
+	DetectorBackend backend_;
+
+	/**
+	 * @brief radius_ is the radius in metres the search is narrowed to, 0 to
+	 * search the whole radius range
+	 */
+	double radius_;
+};
+
+/**
+ * @brief Defines the BandRaster structure which holds everything the
+ * detection stage needs to search one band
+ */
+struct BandRaster {
+
+	/**
+	 * @brief view_ describes the image of the band
+	 */
+	BandView view_;
+
+	/**
+	 * @brief scan_ is the scan with the beams outside the searched area removed
+	 */
+	sensor_msgs::LaserScan::ConstPtr scan_;
+
+	/**
+	 * @brief points_ are the points of the band in metres, the scan first and
+	 * then the previous scans
+	 */
+	std::vector<cv::Point2f> points_;
+
+	/**
+	 * @brief image_ is the blurred image of the band, only drawn for the
+	 * Hough gradient backend
+	 */
+	cv::Mat image_;
+};
+
+/**
+ * @brief Defines the DetectionFrame structure which carries a scan from the
+ * rasterisation stage to the detection stage. The frames are reused, so the
+ * images keep their memory from scan to scan
+ */
+struct DetectionFrame {
+
+	/**
+	 * @brief msg_ is the raw scan
+	 */
+	sensor_msgs::LaserScan::ConstPtr msg_;
+
+	/**
+	 * @brief pose_ is the odometry pose the scan was taken from
+	 */
+	Pose2D pose_;
+
+	/**
+	 * @brief have_odometry_ is true if pose_ comes from the odometry
+	 */
+	bool have_odometry_;
+
+	/**
+	 * @brief bands_ are the bands to search, none if the scan was skipped
+	 */
+	std::vector<BandRaster> bands_;
+
+	/**
+	 * @brief active_bands_ is the number of entries of bands_ in use
+	 */
+	size_t active_bands_;
+
+	/**
+	 * @brief load_level_ is the degradation level the frame is prepared at
+	 */
+	int load_level_;
+
+	/**
+	 * @brief prepare_time_ is the time in seconds the rasterisation took
+	 */
+	double prepare_time_;
+};
+
+/**
+ * @brief Defines the TrackState structure which holds the tracker as it was
+ * after the last detected scan
+ */
+struct TrackState {
+
+	/**
+	 * @brief tracker_ is the tracker after the scan
+	 */
+	CircleTracker tracker_;
+
+	/**
+	 * @brief stamp_ is the time stamp of the scan, zero before the first scan
+	 */
+	ros::Time stamp_;
+
+	/**
+	 * @brief pose_ is the odometry pose of the scan
+	 */
+	Pose2D pose_;
+
+	/**
+	 * @brief have_odometry_ is true if pose_ comes from the odometry
+	 */
+	bool have_odometry_;
+
+	/**
+	 * @brief circle_distance_ is the distance to the published circle in
+	 * metres, -1 if the scan had no circle
+	 */
+	double circle_distance_;
+};
+
+#endif
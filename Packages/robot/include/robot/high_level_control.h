@@ -15,7 +15,12 @@
 #include <ros/ros.h>
 #include <sensor_msgs/LaserScan.h>
 #include "robot/circle_detect_msg.h"
+#include <nav_msgs/Odometry.h>
 #include "move_helpers.h"
+#include "pose_helpers.h"
+#include "scan_deskew.h"
+#include "occupancy_grid.h"
+#include "path_planner.h"
 
 /**
  * @brief Defines the movement of the robot such as the wall following and the
@@ -49,6 +54,26 @@ private:
 	 */
 	ros::Subscriber circle_sub_;
 
+	/**
+	 * @brief Used to get the odometry of the robot
+	 */
+	ros::Subscriber odom_sub_;
+
+	/**
+	 * @brief Used to get the pose of the robot in the map of the world
+	 */
+	ros::Subscriber map_pose_sub_;
+
+	/**
+	 * @brief Used to tell the circle detector whether detections are needed
+	 */
+	ros::Publisher demand_pub_;
+
+	/**
+	 * @brief The demand that was published last
+	 */
+	bool detections_needed_;
+
 	/**
 	 * @brief Contains constants that define the robot moving behavior
 	 */
@@ -69,6 +94,176 @@ private:
 	 */
 	float circle_y_;
 
+	/**
+	 * @brief Detections in a row without the chosen circle
+	 */
+	int follow_misses_;
+
+	/**
+	 * @brief Latest pose from the odometry
+	 */
+	Pose2D odom_pose_;
+
+	/**
+	 * @brief True once an odometry message has been received
+	 */
+	bool have_odometry_;
+
+	/**
+	 * @brief The odometry pose circle_x_ and circle_y_ are relative to
+	 */
+	Pose2D circle_pose_;
+
+	/**
+	 * @brief Odometry poses of the last seconds, to find where the robot was
+	 * when the scan of a detection was taken
+	 */
+	PoseHistory pose_history_;
+
+	/**
+	 * @brief The latest ranges checked for a free path as points, x to the
+	 * right and y forward
+	 */
+	std::vector<float> scan_x_, scan_y_;
+
+	/**
+	 * @brief Latest forward and turn velocity from the odometry
+	 */
+	double odom_linear_velocity_, odom_angular_velocity_;
+
+	/**
+	 * @brief The velocities last sent to the robot, used for the scans when
+	 * there is no odometry
+	 */
+	double commanded_linear_velocity_, commanded_angular_velocity_;
+
+	/**
+	 * @brief True if the scans are corrected for the motion of the robot
+	 * during the sweep before they are used
+	 */
+	bool deskew_scans_;
+
+	/**
+	 * @brief Distance of the LRF in front of the centre the robot turns
+	 * around, in metres
+	 */
+	double laser_offset_;
+
+	/**
+	 * @brief Corrects the scans if deskew_scans_ is set
+	 */
+	ScanDeskewer deskewer_;
+
+	/**
+	 * @brief True if the scans are put into map_
+	 */
+	bool map_enabled_;
+
+	/**
+	 * @brief Map of the space seen so far, in the odometry frame
+	 */
+	OccupancyGrid map_;
+
+	/**
+	 * @brief True if the robot drives to the frontiers of map_ instead of
+	 * following walls
+	 */
+	bool explore_mode_;
+
+	/**
+	 * @brief Frontiers with fewer cells are not driven to
+	 */
+	int frontier_min_size_;
+
+	/**
+	 * @brief Metres of driving one metre of frontier is worth
+	 */
+	double frontier_gain_weight_;
+
+	/**
+	 * @brief True if the robot is driving to a frontier
+	 */
+	bool has_frontier_;
+
+	/**
+	 * @brief The frontier the robot is driving to, in the odometry frame
+	 */
+	Frontier frontier_;
+
+	/**
+	 * @brief Scans since the frontier was picked
+	 */
+	int explore_scans_;
+
+	/**
+	 * @brief Scans in a row the way to the frontier or the goal was blocked
+	 */
+	int blocked_scans_;
+
+	/**
+	 * @brief Frontiers the robot could not get to, never picked again
+	 */
+	std::vector<Frontier> unreachable_frontiers_;
+
+	/**
+	 * @brief True if the robot drives along a path through map_ to the goal
+	 * instead of exploring or following walls
+	 */
+	bool plan_to_goal_;
+
+	/**
+	 * @brief The goal as given, in the map of the world if goal_in_map_ is
+	 * set and in the odometry frame otherwise
+	 */
+	double goal_x_, goal_y_;
+
+	/**
+	 * @brief True if the goal is given in the map of the world
+	 */
+	bool goal_in_map_;
+
+	/**
+	 * @brief The goal in the odometry frame, which the path is planned to
+	 */
+	double odom_goal_x_, odom_goal_y_;
+
+	/**
+	 * @brief True once the goal is known in the odometry frame
+	 */
+	bool has_odom_goal_;
+
+	/**
+	 * @brief Finds the path to the goal, repairing the last one as map_ grows
+	 */
+	PathPlanner planner_;
+
+	/**
+	 * @brief Waypoints of the path to the goal, empty if there is none
+	 */
+	std::vector<double> path_x_, path_y_;
+
+	/**
+	 * @brief Scans since the path was planned
+	 */
+	int plan_scans_;
+
+	/**
+	 * @brief True once the robot reached the goal or gave it up
+	 */
+	bool plan_finished_;
+
+	/**
+	 * @brief True once the pose of the robot in the map of the world is
+	 * known well enough
+	 */
+	bool localised_;
+
+	/**
+	 * @brief The latest pose in the map of the world and the odometry pose
+	 * the robot had then
+	 */
+	Pose2D map_fix_, map_fix_odom_;
+
 	/**
 	 * @brief Gets the data from the laser range finder, examines them and
 	 * updates the relevant class variables
@@ -84,6 +279,26 @@ private:
 	 */
 	void CircleCallback(const robot::circle_detect_msg::ConstPtr& msg);
 
+	/**
+	 * @brief Stores the pose of the robot and moves the circle along with it
+	 *
+	 * @param msg The odometry message
+	 */
+	void OdomCallback(const nav_msgs::Odometry::ConstPtr& msg);
+
+	/**
+	 * @brief Stores the pose of the robot in the map of the world once the
+	 * localisation is sure enough of it
+	 *
+	 * @param msg The pose in the map with its covariance
+	 */
+	void MapPoseCallback(const nav_msgs::Odometry::ConstPtr& msg);
+
+	/**
+	 * @brief Publishes whether detections are needed, if that has changed
+	 */
+	void UpdateDetectionDemand();
+
 
 	/**
 	 * @brief Analyses the ranges given by the laser range finder and updates the
@@ -131,12 +346,85 @@ private:
 	void AlignRobot(std::vector<float>& ranges);
 
 	/**
-	 * @brief Adjusts the robot and sends it towards the circle
+	 * @brief Drives the robot on an arc to the circle centre, slowing down
+	 * as the free distance ahead shrinks, and stops once it touches it
 	 * 
 	 * @param ranges The values received from the LRF
 	 */
 	void GoToCircle(std::vector<float>& ranges);
 
+	/**
+	 * @brief Checks if the robot can hit a circle, with the ranges already
+	 * turned into scan_x_ and scan_y_
+	 *
+	 * @param circle_x The x-coordinate of the circle relative to the robot
+	 * @param circle_y The y-coordinate of the circle relative to the robot
+	 * @param ranges The laser range finder ranges scan_x_ and scan_y_ were
+	 * made of
+	 * @return Returns true if the circle is seen and the path to it is free
+	 */
+	bool CircleInReach(double circle_x, double circle_y, std::vector<float>& ranges);
+
+	/**
+	 * @brief Picks the side of the wall to follow, the one that looks into
+	 * more unknown space of the map, or a random one if the map cannot tell
+	 *
+	 * @return Returns RIGHT or LEFT
+	 */
+	TurnType ChooseTurnType();
+
+	/**
+	 * @brief Returns true if the robot explores the frontiers of the map
+	 * instead of following walls
+	 */
+	bool Exploring();
+
+	/**
+	 * @brief Picks the frontier with the most cells for the way to it, if
+	 * there is any
+	 */
+	void PickFrontier();
+
+	/**
+	 * @brief Drives the robot on an arc to the frontier it picked, turning
+	 * away from obstacles like the wall following does. Without frontiers
+	 * it follows walls
+	 */
+	void ExploreMove();
+
+	/**
+	 * @brief Returns true if the robot drives along a path to the goal
+	 */
+	bool Planning();
+
+	/**
+	 * @brief Drives the robot along the path to the goal, planning it anew
+	 * every few scans and when the way is blocked. The way is blocked if
+	 * something is closer than high_security_distance_ on the way of the
+	 * robot to the next waypoint. Without a path it follows walls until the
+	 * map opens one
+	 *
+	 * @param ranges ranges of data in the laser range finder
+	 */
+	void PlanMove(std::vector<float>& ranges);
+
+	/**
+	 * @brief Moves a goal given in the map of the world into the odometry
+	 * frame with the pose from GetMapPose, planning anew if the localisation
+	 * moved it
+	 *
+	 * @return Returns false while the goal is not known in the odometry frame
+	 */
+	bool UpdateGoal();
+
+	/**
+	 * @brief Drives the robot on an arc to a point, turning in place first
+	 * if the point is behind it
+	 *
+	 * @param x, y The point in the odometry frame
+	 */
+	void MoveTowards(double x, double y);
+
 public:
 	/**
 	 * @brief The default constructor for the HighLevelControl class
@@ -159,6 +447,11 @@ public:
 	/**
 	 * @brief Checks if the robots path is clear and it can hit the circle
 	 *
+	 * @details The circle has to be in front of the robot within
+	 * hit_distance_ and the beam towards its centre has to end before it.
+	 * The path is clear if none of the points of the scan lies in the
+	 * rectangle of the robot's width from the robot to where that beam ends
+	 *
 	 * @param circle_x The x-coordinate of the circle in cartesian coordinates
 	 * relative to the robot
 	 * @param circle_y The y-coordinate of the circle in cartesian coordinates
@@ -168,6 +461,55 @@ public:
 	 */
 	bool CanHit(double circle_x, double circle_y, std::vector<float>& ranges);
 
+	/**
+	 * @brief Checks the detected circle and then every candidate, most
+	 * confident first, and picks the first one the robot can hit
+	 *
+	 * @param msg The circles detected in the latest scan
+	 * @param ranges The laser range finder ranges in std::vector<float> format
+	 * @return Returns true if one of the circles can be hit. circle_x_ and
+	 * circle_y_ are set to it, or to the detected circle otherwise
+	 */
+	bool ChooseCircle(const robot::circle_detect_msg& msg, std::vector<float>& ranges);
+
+	/**
+	 * @brief Keeps circle_x_ and circle_y_ on the circle that was chosen to
+	 * be hit, using the detected circle closest to it. Without one close
+	 * enough the circle moved by the odometry is kept, until it was missed
+	 * too often and is taken as lost
+	 *
+	 * @param msg The circles detected in the latest scan
+	 */
+	void FollowCircle(const robot::circle_detect_msg& msg);
+
+	/**
+	 * @brief Checks whether the circle detections are of any use right now.
+	 * They are not before a wall is followed, since no circle can be hit
+	 * then, and not once the goal is reached. While going to the circle
+	 * they steer the robot
+	 *
+	 * @return Returns true if the circle detector should be running
+	 */
+	bool NeedsDetections();
+
+	/**
+	 * @brief Moves circle_x_ and circle_y_ into the frame of the robot at a
+	 * new pose, so they stay valid while the detector runs slower than the
+	 * control loop
+	 *
+	 * @param pose The new odometry pose of the robot
+	 */
+	void PropagateCircle(const Pose2D& pose);
+
+	/**
+	 * @brief Moves the circles of a detection from the frame of the robot
+	 * when its scan was taken into the frame of the robot now. Without
+	 * odometry reaching back to the scan they are left as they are
+	 *
+	 * @param msg The detection, changed in place
+	 */
+	void MoveDetection(robot::circle_detect_msg& msg);
+
 	/**
 	 * @brief Checks whether the robot can continue in the same path. If the
 	 * security distance is close it sets the can_continue_ to false
@@ -221,6 +563,43 @@ public:
 		return move_status_;
 	}
 
+	/**
+	 * @brief Getter for the map of the space seen so far
+	 *
+	 * @return Returns map_
+	 */
+	const OccupancyGrid& get_map() {
+		return map_;
+	}
+
+	/**
+	 * @brief Finds the current pose of the robot in the map of the world,
+	 * the latest localised pose moved on by the odometry since
+	 *
+	 * @param pose Set to the pose
+	 * @return Returns false if the robot is not localised, pose is left
+	 * unchanged then
+	 */
+	bool GetMapPose(Pose2D& pose) const;
+
+	/**
+	 * @brief Getter for the x coordinate of the circle
+	 *
+	 * @return Returns circle_x_
+	 */
+	float get_circle_x() {
+		return circle_x_;
+	}
+
+	/**
+	 * @brief Getter for the y coordinate of the circle
+	 *
+	 * @return Returns circle_y_
+	 */
+	float get_circle_y() {
+		return circle_y_;
+	}
+
 	/**
 	 * @brief Setter for turn type
 	 *
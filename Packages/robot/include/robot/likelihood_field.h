@@ -0,0 +1,138 @@
+/**
+ * @file likelihood_field.h
+ * @brief Header file for the likelihood of a laser beam ending at a point of
+ * a known map.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef LIKELIHOOD_FIELD_H
+#define LIKELIHOOD_FIELD_H
+
+#include <vector>
+
+/**
+ * @brief Computes the exact squared Euclidean distance of every cell of a map
+ * to the closest obstacle, in cells
+ *
+ * @param squared 0 for the obstacles and a big number for the other cells,
+ * row after row, replaced by the squared distances
+ * @param width The number of cells of a row
+ * @param height The number of rows
+ */
+void SquaredDistanceTransform(std::vector<double>& squared, int width, int height);
+
+/**
+ * @brief Defines the LikelihoodField class which keeps, for every cell of a
+ * known map, the distance to the closest obstacle and the log-likelihood of
+ * a beam ending in the cell.
+ *
+ * @details The distances are the exact Euclidean distance transform of the
+ * map. The likelihood of a beam end is a Gaussian of its distance to the
+ * closest obstacle plus a constant share for random returns. The field has
+ * a border of one cell with the likelihood of random returns only, so
+ * points outside the map are clamped onto it instead of being checked.
+ *
+ * Usage:
+ *     field.SetMap(occupied, width, height, 0.01, -3, -2, 0.05);
+ *     float log_likelihood = field.SumLogLikelihood(x, y, count);
+ */
+class LikelihoodField {
+private:
+    /**
+     * @brief Size of the map in cells
+     */
+    int width_, height_;
+
+    /**
+     * @brief Side of a cell in metres
+     */
+    double resolution_;
+
+    /**
+     * @brief Position of the lower left corner of the map
+     */
+    double origin_x_, origin_y_;
+
+    /**
+     * @brief Distance of every cell to the closest obstacle in metres, row
+     * after row from the bottom
+     */
+    std::vector<float> distance_;
+
+    /**
+     * @brief Log-likelihood of a beam ending in every cell, with a border
+     * of one cell around the map
+     */
+    std::vector<float> log_likelihood_;
+
+    /**
+     * @brief Indexes of the cells that are not occupied
+     */
+    std::vector<int> free_cells_;
+
+public:
+    /**
+     * @brief Default constructor for LikelihoodField, without a map
+     */
+    LikelihoodField();
+
+    /**
+     * @brief Computes the field of a map
+     *
+     * @param occupied Non-zero for the occupied cells, row after row from the
+     * bottom
+     * @param width The number of cells of a row
+     * @param height The number of rows
+     * @param resolution Side of a cell in metres
+     * @param origin_x, origin_y Position of the lower left corner of the map
+     * @param hit_sigma Standard deviation of a beam end around an obstacle in
+     * metres
+     */
+    void SetMap(const std::vector<unsigned char>& occupied, int width, int height,
+                double resolution, double origin_x, double origin_y, double hit_sigma);
+
+    /**
+     * @brief Returns true if a map has been set
+     */
+    bool HasMap() const;
+
+    /**
+     * @brief Distance of a point to the closest obstacle in metres, 0 outside
+     * the map
+     */
+    double Distance(double x, double y) const;
+
+    /**
+     * @brief Sums the log-likelihoods of beams ending at some points
+     *
+     * @param x, y The points
+     * @param count The number of points
+     * @return Returns the sum
+     */
+    float SumLogLikelihood(const float* x, const float* y, int count) const;
+
+    /**
+     * @brief Indexes of the cells that are not occupied, for CellCentre
+     */
+    const std::vector<int>& FreeCells() const;
+
+    /**
+     * @brief Finds the centre of a cell
+     *
+     * @param cell The index of the cell, row after row from the bottom
+     * @param x, y Set to the centre
+     */
+    void CellCentre(int cell, double& x, double& y) const;
+
+    /**
+     * @brief Side of a cell in metres
+     */
+    double Resolution() const;
+};
+
+#endif
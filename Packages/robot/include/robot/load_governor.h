@@ -0,0 +1,109 @@
+/**
+ * @file load_governor.h
+ * @brief Header file for the governor that degrades the circle detector
+ * when it cannot keep up with the scans.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef LOAD_GOVERNOR_H
+#define LOAD_GOVERNOR_H
+
+#include "detect_helpers.h"
+
+/**
+ * @brief Defines the degradation levels of the detector where every level
+ * includes the ones below it. LOAD_NORMAL=0, LOAD_SKIP_FRAMES=1,
+ * LOAD_COARSE_RASTER=2, LOAD_NARROW_RADIUS=3, LOAD_CHEAP_BACKEND=4
+ */
+enum LoadLevel {
+	LOAD_NORMAL, LOAD_SKIP_FRAMES, LOAD_COARSE_RASTER, LOAD_NARROW_RADIUS, LOAD_CHEAP_BACKEND
+};
+
+/**
+ * @brief Defines the LoadGovernor class which picks the degradation level of
+ * the detector from the time it takes per frame.
+ *
+ * @details The load of a frame is its processing time divided by the time
+ * available for it, which is the scan period times the number of scans per
+ * detected frame. The load is averaged over the frames. Above the overload
+ * share the governor steps one level down in quality, below the headroom
+ * share for hold_frames_ frames in a row it steps one level back up. After
+ * every step the load is only watched for hold_frames_ frames, so the
+ * average settles at the new level before the next step.
+ *
+ * Usage:
+ *     governor.SetParams(params);
+ *     int level = governor.Update(processing_time, available_time);
+ */
+class LoadGovernor {
+private:
+    /**
+     * @brief Parameters of the governor
+     */
+    GovernorParams params_;
+
+    /**
+     * @brief The current level
+     */
+    int level_;
+
+    /**
+     * @brief The averaged load, negative before the first frame
+     */
+    double load_;
+
+    /**
+     * @brief Number of frames to go until the load is acted on again
+     */
+    int hold_;
+
+    /**
+     * @brief Number of frames in a row below the headroom
+     */
+    int calm_frames_;
+
+public:
+    /**
+     * @brief Default constructor for LoadGovernor, disabled at LOAD_NORMAL
+     */
+    LoadGovernor();
+
+    /**
+     * @brief Sets the parameters of the governor. Disabling it returns to
+     * LOAD_NORMAL
+     */
+    void SetParams(const GovernorParams& params);
+
+    /**
+     * @brief Returns to LOAD_NORMAL and forgets the load
+     */
+    void Reset();
+
+    /**
+     * @brief Adds the processing time of a frame and picks the level for the
+     * next one
+     *
+     * @param processing_time The time the frame took in seconds
+     * @param available_time The time there was for the frame in seconds.
+     * Frames without a known time are ignored
+     * @return The level for the next frame
+     */
+    int Update(double processing_time, double available_time);
+
+    /**
+     * @brief The current level
+     */
+    int Level() const;
+
+    /**
+     * @brief The averaged share of the available time used per frame
+     */
+    double Load() const;
+};
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file local_point_map.h
+ * @brief Header file for the rolling map of the last few laser scans.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef LOCAL_POINT_MAP_H
+#define LOCAL_POINT_MAP_H
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "pose_helpers.h"
+
+/**
+ * @brief Defines the LocalPointMap class which keeps the points of the last
+ * few scans together with the odometry pose they were taken from.
+ *
+ * @details The scans are kept in a ring of fixed size, so the memory stays
+ * bounded and the oldest scan is overwritten first. The points are stored in
+ * the frame of the circle detector (x to the right, y forward, in metres) of
+ * the pose they were seen from and are only moved into the current frame
+ * when they are collected, so odometry errors do not add up from scan to
+ * scan. The points are seen from the LRF, which sits in front of the centre
+ * the robot turns around, so they are moved by the motion of the LRF.
+ *
+ * Usage:
+ *     local_map.Collect(pose, history);
+ *     local_map.Add(points, pose);
+ */
+class LocalPointMap {
+private:
+    /**
+     * @brief The points of a single scan
+     */
+    struct Frame {
+        /**
+         * @brief Odometry pose the scan was taken from
+         */
+        Pose2D pose_;
+
+        /**
+         * @brief The points in the detector frame of pose_
+         */
+        std::vector<cv::Point2f> points_;
+    };
+
+    /**
+     * @brief Ring of the stored scans
+     */
+    std::vector<Frame> frames_;
+
+    /**
+     * @brief Index of the frame that is overwritten next
+     */
+    size_t next_;
+
+    /**
+     * @brief Number of stored scans
+     */
+    size_t count_;
+
+    /**
+     * @brief Distance of the LRF in front of the centre the robot turns
+     * around, in metres
+     */
+    double laser_offset_;
+
+public:
+    /**
+     * @brief Default constructor for LocalPointMap, which stores no scans
+     */
+    LocalPointMap();
+
+    /**
+     * @brief Sets the number of scans that are kept, dropping all of them if
+     * the number changes
+     *
+     * @param scans The number of scans
+     */
+    void SetCapacity(int scans);
+
+    /**
+     * @brief Sets where the LRF sits on the robot
+     *
+     * @param laser_offset Distance of the LRF in front of the centre the
+     * robot turns around, in metres
+     */
+    void SetLaserOffset(double laser_offset);
+
+    /**
+     * @brief Drops all scans
+     */
+    void Clear();
+
+    /**
+     * @brief Stores a scan, overwriting the oldest one if the map is full
+     *
+     * @param points The points of the scan in the detector frame
+     * @param pose The odometry pose the scan was taken from
+     */
+    void Add(const std::vector<cv::Point2f>& points, const Pose2D& pose);
+
+    /**
+     * @brief Moves the points of all stored scans into the frame of a pose
+     *
+     * @param pose The odometry pose of the robot now
+     * @param points Filled with the points in the detector frame of pose
+     */
+    void Collect(const Pose2D& pose, std::vector<cv::Point2f>& points) const;
+};
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * @file localisation.h
+ * @brief This file defines the Localisation class
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef LOCALISATION_H
+#define LOCALISATION_H
+
+#include <string>
+#include <vector>
+#include <ros/ros.h>
+#include <sensor_msgs/LaserScan.h>
+#include <nav_msgs/Odometry.h>
+#include "particle_filter.h"
+#include "pose_helpers.h"
+
+/**
+ * @brief Defines the localisation of the robot in the map of a stage world.
+ * The floor plan bitmap of the world is loaded and the robot is localised in
+ * it from its scans and odometry with a ParticleFilter. The pose in the map
+ * is published after every scan that updated it
+ *
+ * Usage:
+ *     Localisation localisation;
+ */
+class Localisation {
+
+private:
+
+	/**
+	 * @brief Ros node to which the class is attached
+	 */
+	ros::NodeHandle node_;
+
+	/**
+	 * @brief Used to get the data from the laser range finder
+	 */
+	ros::Subscriber laser_sub_;
+
+	/**
+	 * @brief Used to get the odometry of the robot
+	 */
+	ros::Subscriber odom_sub_;
+
+	/**
+	 * @brief Used to publish the pose of the robot in the map
+	 */
+	ros::Publisher pose_pub_;
+
+	/**
+	 * @brief Finds the pose of the robot in the map
+	 */
+	ParticleFilter filter_;
+
+	/**
+	 * @brief Latest pose from the odometry
+	 */
+	Pose2D odom_pose_;
+
+	/**
+	 * @brief True once an odometry message has been received
+	 */
+	bool have_odometry_;
+
+	/**
+	 * @brief The odometry pose of the last scan that updated the filter
+	 */
+	Pose2D update_pose_;
+
+	/**
+	 * @brief True once a scan has updated the filter
+	 */
+	bool updated_;
+
+	/**
+	 * @brief Loads the parameters and the map and connects the topics
+	 */
+	void Initialise();
+
+public:
+
+	/**
+	 * @brief Default constructor for Localisation
+	 */
+	Localisation();
+
+	/**
+	 * @brief Reads the floor plan of a stage world file into a map
+	 *
+	 * @param world_file The path of the world file, the bitmap is looked for
+	 * next to it
+	 * @param occupied Filled with non-zero for the occupied cells, row after
+	 * row from the bottom
+	 * @param width, height Set to the size of the map in cells
+	 * @param resolution Set to the side of a cell in metres
+	 * @param origin_x, origin_y Set to the lower left corner of the map
+	 * @return Returns false if the world has no floor plan or its bitmap can
+	 * not be read
+	 */
+	static bool LoadWorld(const std::string& world_file, std::vector<unsigned char>& occupied,
+	                      int& width, int& height, double& resolution,
+	                      double& origin_x, double& origin_y);
+
+	/**
+	 * @brief Keeps the latest odometry pose
+	 *
+	 * @param msg The odometry of the robot
+	 */
+	void OdomCallback(const nav_msgs::Odometry::ConstPtr& msg);
+
+	/**
+	 * @brief Moves the particles by the odometry since the last update and
+	 * weights them by the scan, once the robot has moved far enough
+	 *
+	 * @param msg The new scan
+	 */
+	void LaserCallback(const sensor_msgs::LaserScan::ConstPtr& msg);
+
+	/**
+	 * @brief The filter the robot is localised with
+	 */
+	const ParticleFilter& get_filter() {
+		return filter_;
+	}
+};
+
+#endif
@@ -66,6 +66,31 @@ struct MoveSpecs {
      */
     int cumulative_angle_;
 
+    /**
+     * @brief Distance in front of the robot at which it touches the circle
+     */
+    double contact_distance_;
+
+    /**
+     * @brief Highest linear velocity while approaching the circle
+     */
+    double approach_velocity_;
+
+    /**
+     * @brief Deceleration the approach to the circle is planned with
+     */
+    double approach_deceleration_;
+
+    /**
+     * @brief Width of the robot, the path to the circle has to be free over
+     */
+    double robot_width_;
+
+    /**
+     * @brief Farthest distance to the centre of a circle the robot goes for
+     */
+    double hit_distance_;
+
     /**
      * @brief Specifies the type of turn the robot should make when it is far
      * from the wall
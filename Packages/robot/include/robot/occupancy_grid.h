@@ -0,0 +1,217 @@
+/**
+ * @file occupancy_grid.h
+ * @brief Header file for the map the robot builds of the space it has seen.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "pose_helpers.h"
+
+/**
+ * @brief Defines what is known about a cell of the map where
+ * CELL_UNKNOWN=0, CELL_FREE=1, CELL_OCCUPIED=2
+ */
+enum CellState {
+    CELL_UNKNOWN, CELL_FREE, CELL_OCCUPIED
+};
+
+/**
+ * @brief Defines the Frontier structure which describes a connected piece of
+ * the border between free and unknown space
+ */
+struct Frontier {
+    /**
+     * @brief x coordinate of the cell of the frontier closest to its centre
+     */
+    double x_;
+
+    /**
+     * @brief y coordinate of the cell of the frontier closest to its centre
+     */
+    double y_;
+
+    /**
+     * @brief Number of cells of the frontier
+     */
+    int size_;
+};
+
+/**
+ * @brief Defines the OccupancyGrid class which keeps the log-odds of every
+ * cell of the odometry frame being occupied.
+ *
+ * @details Every beam of a scan makes the cells it passes through more
+ * likely free and the cell it ends in more likely occupied. The cells are
+ * stored in square tiles that are only created once a beam reaches them, so
+ * the map grows with the explored space and neighbouring cells lie next to
+ * each other in memory. A scan updates at most max_beams_ beams of at most
+ * max_range_ each, which bounds its cost.
+ *
+ * Usage:
+ *     grid.SetParams(0.05, 4, 180, 0.15);
+ *     grid.Update(pose, ranges, angle_min, angle_increment, range_max);
+ *     if (grid.State(x, y) == CELL_UNKNOWN) { ... }
+ */
+class OccupancyGrid {
+private:
+    /**
+     * @brief Side of a cell in metres
+     */
+    double resolution_;
+
+    /**
+     * @brief Beams are only followed this far in metres
+     */
+    double max_range_;
+
+    /**
+     * @brief Most beams of a scan that are put into the map
+     */
+    int max_beams_;
+
+    /**
+     * @brief Distance of the laser range finder in front of the centre of
+     * the robot in metres
+     */
+    double laser_offset_;
+
+    /**
+     * @brief The log-odds of the cells, tile after tile
+     */
+    std::vector<std::vector<float> > tiles_;
+
+    /**
+     * @brief Index into tiles_ of every tile by its key
+     */
+    std::unordered_map<long long, int> tile_index_;
+
+    /**
+     * @brief Where every beam of the scan ends, in cell units
+     */
+    std::vector<float> end_x_, end_y_;
+
+    /**
+     * @brief True for the beams of the scan that ended on an obstacle
+     */
+    std::vector<unsigned char> hit_;
+
+    /**
+     * @brief Key and index of the tile used last, as the cells of a beam
+     * mostly lie in the same tile
+     */
+    long long last_key_;
+    int last_tile_;
+
+    /**
+     * @brief Returns the log-odds of a cell, created if needed
+     */
+    float& Cell(int cell_x, int cell_y);
+
+    /**
+     * @brief Returns the tile with the cell, NULL if it was never created
+     */
+    const std::vector<float>* FindTile(int cell_x, int cell_y) const;
+
+    /**
+     * @brief Returns the log-odds of a cell, 0 if it was never seen
+     */
+    float CellLogOdds(int cell_x, int cell_y) const;
+
+    /**
+     * @brief Follows a beam through the cells from the start to the end,
+     * both in cell units
+     *
+     * @param hit True if the beam ended on an obstacle
+     */
+    void TraceBeam(float start_x, float start_y, float end_x, float end_y, bool hit);
+
+public:
+    /**
+     * @brief Default constructor for OccupancyGrid, with 5 cm cells
+     */
+    OccupancyGrid();
+
+    /**
+     * @brief Sets the parameters of the map. A new resolution clears it
+     *
+     * @param resolution Side of a cell in metres
+     * @param max_range Beams are only followed this far in metres
+     * @param max_beams Most beams of a scan put into the map
+     * @param laser_offset Distance of the laser range finder in front of the
+     * centre of the robot in metres
+     */
+    void SetParams(double resolution, double max_range, int max_beams, double laser_offset);
+
+    /**
+     * @brief Forgets everything in the map
+     */
+    void Clear();
+
+    /**
+     * @brief Puts a scan into the map
+     *
+     * @param pose The pose of the robot in the odometry frame when the scan
+     * was taken
+     * @param ranges The ranges of the scan
+     * @param angle_min Angle of the first beam, counterclockwise from forward
+     * @param angle_increment Angle between two beams
+     * @param range_max Ranges from this on saw nothing
+     */
+    void Update(const Pose2D& pose, const std::vector<float>& ranges,
+                double angle_min, double angle_increment, double range_max);
+
+    /**
+     * @brief The log-odds of a point being occupied, 0 if unknown
+     */
+    double LogOdds(double x, double y) const;
+
+    /**
+     * @brief What is known about a point of the odometry frame
+     *
+     * @return Returns the CellState of the cell with the point
+     */
+    int State(double x, double y) const;
+
+    /**
+     * @brief Counts the unknown cells a look in a direction would reveal
+     *
+     * @param x The x coordinate to look from
+     * @param y The y coordinate to look from
+     * @param angle The direction in the odometry frame
+     * @param distance How far to look in metres
+     * @return Returns the number of unknown cells before the first occupied
+     * one
+     */
+    int UnknownAlong(double x, double y, double angle, double distance) const;
+
+    /**
+     * @brief Finds the frontiers of the map, the free cells next to unknown
+     * ones grouped into connected pieces of at most one tile
+     *
+     * @param min_size Frontiers with fewer cells are left out
+     * @param frontiers Filled with the frontiers
+     */
+    void FindFrontiers(int min_size, std::vector<Frontier>& frontiers) const;
+
+    /**
+     * @brief Number of tiles created so far
+     */
+    size_t TileCount() const;
+
+    /**
+     * @brief Side of a cell in metres
+     */
+    double Resolution() const;
+};
+
+#endif
@@ -0,0 +1,176 @@
+/**
+ * @file particle_filter.h
+ * @brief Header file for the localisation of the robot in a known map.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef PARTICLE_FILTER_H
+#define PARTICLE_FILTER_H
+
+#include <cstddef>
+#include <random>
+#include <unordered_set>
+#include <vector>
+#include "likelihood_field.h"
+#include "pose_helpers.h"
+
+/**
+ * @brief Defines the ParticleFilter class which finds the pose of the robot
+ * in a known map by Monte Carlo localisation.
+ *
+ * @details Every particle is a guess of the pose. The particles follow the
+ * odometry with some noise, are weighted by how well a scan fits the map
+ * from their pose and are then drawn anew by their weights. The weight of a
+ * particle is the summed log-likelihood of its beam ends in a LikelihoodField,
+ * with the ends computed for all beams in one loop without branches. The
+ * number of particles drawn adapts with KLD sampling: as long as the
+ * particles cover many bins of the pose space many are drawn, once they
+ * gather around one pose few are enough.
+ *
+ * Usage:
+ *     filter.SetMap(occupied, width, height, 0.01, -3, -2, 0.05);
+ *     filter.InitialiseGlobal();
+ *     filter.Predict(motion);
+ *     filter.Correct(ranges, angle_min, angle_increment, range_max);
+ *     Pose2D pose = filter.Estimate();
+ */
+class ParticleFilter {
+private:
+    /**
+     * @brief The map the scans are compared with
+     */
+    LikelihoodField field_;
+
+    /**
+     * @brief Least and most particles drawn after a scan
+     */
+    int min_particles_, max_particles_;
+
+    /**
+     * @brief Most beams of a scan that weight the particles
+     */
+    int max_beams_;
+
+    /**
+     * @brief Distance of the laser range finder in front of the centre of
+     * the robot in metres
+     */
+    double laser_offset_;
+
+    /**
+     * @brief The particles and their weights, which add up to 1
+     */
+    std::vector<Pose2D> particles_;
+    std::vector<double> weights_;
+
+    /**
+     * @brief Log-likelihood of the latest scan for every particle
+     */
+    std::vector<double> likelihoods_;
+
+    /**
+     * @brief The particles being drawn and the summed weights they are
+     * drawn by
+     */
+    std::vector<Pose2D> drawn_;
+    std::vector<double> cumulative_;
+
+    /**
+     * @brief Bins of the pose space the drawn particles fall into
+     */
+    std::unordered_set<long long> bins_;
+
+    /**
+     * @brief Ends of the used beams as seen from the robot, and as seen from
+     * the map for one particle
+     */
+    std::vector<float> beam_x_, beam_y_, end_x_, end_y_;
+
+    /**
+     * @brief Source of the noise and the drawing
+     */
+    std::mt19937 random_;
+
+    /**
+     * @brief Draws the particles anew by their weights, as many as KLD
+     * sampling asks for
+     */
+    void Resample();
+
+public:
+    /**
+     * @brief Default constructor for ParticleFilter, without a map
+     */
+    ParticleFilter();
+
+    /**
+     * @brief Sets the parameters of the filter
+     *
+     * @param min_particles Least particles drawn after a scan
+     * @param max_particles Most particles drawn after a scan
+     * @param max_beams Most beams of a scan that weight the particles
+     * @param laser_offset Distance of the laser range finder in front of the
+     * centre of the robot in metres
+     */
+    void SetParams(int min_particles, int max_particles, int max_beams, double laser_offset);
+
+    /**
+     * @brief Sets the map the robot is localised in, see LikelihoodField
+     */
+    void SetMap(const std::vector<unsigned char>& occupied, int width, int height,
+                double resolution, double origin_x, double origin_y, double hit_sigma);
+
+    /**
+     * @brief The map the robot is localised in
+     */
+    const LikelihoodField& Field() const;
+
+    /**
+     * @brief Spreads the most particles evenly over the free space of the
+     * map with any heading, for a robot that knows nothing about its pose
+     */
+    void InitialiseGlobal();
+
+    /**
+     * @brief Moves the particles by the odometry of the robot
+     *
+     * @param motion The motion since the last call, as returned by
+     * RelativePose
+     */
+    void Predict(const Pose2D& motion);
+
+    /**
+     * @brief Weights the particles by a scan and draws them anew once only a
+     * few of them carry most of the weight
+     *
+     * @param ranges The ranges of the scan
+     * @param angle_min Angle of the first beam, counterclockwise from forward
+     * @param angle_increment Angle between two beams
+     * @param range_max Ranges from this on saw nothing and are not used
+     */
+    void Correct(const std::vector<float>& ranges, double angle_min,
+                 double angle_increment, double range_max);
+
+    /**
+     * @brief The weighted mean pose of the particles
+     */
+    Pose2D Estimate() const;
+
+    /**
+     * @brief Standard deviation of the positions of the particles in metres,
+     * small once the robot is localised
+     */
+    double Spread() const;
+
+    /**
+     * @brief Number of particles
+     */
+    size_t ParticleCount() const;
+};
+
+#endif
@@ -0,0 +1,205 @@
+/**
+ * @file path_planner.h
+ * @brief Header file for the planning of a path to a goal through the map
+ * the robot builds.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef PATH_PLANNER_H
+#define PATH_PLANNER_H
+
+#include <set>
+#include <utility>
+#include <vector>
+#include "occupancy_grid.h"
+
+/**
+ * @brief Defines the PathPlanner class which finds the shortest path from the
+ * robot to a goal through an OccupancyGrid with D* Lite.
+ *
+ * @details The planner works on a window of the map around the robot and the
+ * goal. Unknown cells are taken to be free. The distances of the cells to the
+ * closest occupied one come from a distance transform. Cells closer than the
+ * inflation radius are blocked and cells within the caution distance beyond
+ * it cost more to drive through. The search runs from the goal to the robot,
+ * so when the map changes only the cells whose cost changed are updated and
+ * the search repairs the part of the old one they affect.
+ *
+ * Usage:
+ *     planner.SetParams(0.23, 0.25);
+ *     planner.SetGoal(4, 0);
+ *     if (planner.Plan(map, x, y, path_x, path_y)) { ... }
+ */
+class PathPlanner {
+private:
+    /**
+     * @brief Cells closer than this to an obstacle in metres are blocked
+     */
+    double inflation_radius_;
+
+    /**
+     * @brief Cells within this distance beyond the inflation radius cost more
+     */
+    double caution_distance_;
+
+    /**
+     * @brief The goal in the odometry frame
+     */
+    double goal_x_, goal_y_;
+
+    /**
+     * @brief True once a goal has been set
+     */
+    bool has_goal_;
+
+    /**
+     * @brief Side of a cell in metres, as in the map
+     */
+    double resolution_;
+
+    /**
+     * @brief Map cell of the lower left corner of the window and its size in
+     * cells
+     */
+    int window_x_, window_y_, width_, height_;
+
+    /**
+     * @brief Cell of the goal and of the robot in the window, -1 without a
+     * window
+     */
+    int goal_cell_, start_cell_;
+
+    /**
+     * @brief Added to the keys as the robot moves, instead of changing the
+     * keys of all queued cells
+     */
+    float key_modifier_;
+
+    /**
+     * @brief Extra cost of every cell per metre driven through it, infinity
+     * for blocked cells
+     */
+    std::vector<float> cost_;
+
+    /**
+     * @brief Cost of the best path from every cell to the goal found so far,
+     * and the one looking ahead by one step
+     */
+    std::vector<float> g_, rhs_;
+
+    /**
+     * @brief The key every queued cell was queued with
+     */
+    std::vector<std::pair<float, float> > keys_;
+
+    /**
+     * @brief True for the queued cells
+     */
+    std::vector<unsigned char> queued_;
+
+    /**
+     * @brief Cells that have to be looked at, by their keys
+     */
+    std::set<std::pair<std::pair<float, float>, int> > queue_;
+
+    /**
+     * @brief Occupied cells and squared distances of the window, and the
+     * costs from the latest map, kept to avoid allocations
+     */
+    std::vector<double> squared_;
+    std::vector<float> new_cost_;
+
+    /**
+     * @brief Makes a new window around the robot and the goal and forgets the
+     * search
+     */
+    void ResetWindow(const OccupancyGrid& map, double start_x, double start_y);
+
+    /**
+     * @brief Computes the costs of the window cells from the map
+     *
+     * @param costs Filled with the costs
+     */
+    void ComputeCosts(const OccupancyGrid& map, std::vector<float>& costs);
+
+    /**
+     * @brief Returns the window cell of a point, -1 outside the window or on
+     * its border
+     */
+    int WindowCell(double x, double y) const;
+
+    /**
+     * @brief The cost of driving from a cell to its neighbour in direction
+     */
+    float StepCost(int cell, int direction) const;
+
+    /**
+     * @brief Returns the neighbour of a cell in a direction, -1 outside the
+     * window
+     */
+    int Neighbour(int cell, int direction) const;
+
+    /**
+     * @brief Estimate of the cost between two cells that is never too high
+     */
+    float Heuristic(int from, int to) const;
+
+    /**
+     * @brief The key a cell is queued with
+     */
+    std::pair<float, float> Key(int cell) const;
+
+    /**
+     * @brief Recomputes the look-ahead cost of a cell and queues it if it is
+     * inconsistent
+     */
+    void UpdateCell(int cell);
+
+    /**
+     * @brief Looks at queued cells until the cost of the robot's cell is
+     * known
+     */
+    void ComputeShortestPath();
+
+public:
+    /**
+     * @brief Default constructor for PathPlanner, without a goal
+     */
+    PathPlanner();
+
+    /**
+     * @brief Sets the parameters of the planner. Makes it plan anew
+     *
+     * @param inflation_radius Cells closer than this to an obstacle in metres
+     * are blocked
+     * @param caution_distance Cells within this distance beyond the inflation
+     * radius cost more
+     */
+    void SetParams(double inflation_radius, double caution_distance);
+
+    /**
+     * @brief Sets the goal in the odometry frame. Makes it plan anew
+     */
+    void SetGoal(double x, double y);
+
+    /**
+     * @brief Finds the path from the robot to the goal through the map,
+     * reusing the last search where the map has not changed
+     *
+     * @param map The map the robot builds
+     * @param start_x, start_y The position of the robot in the odometry frame
+     * @param path_x, path_y Filled with waypoints along the path, about 0.3
+     * metres apart, the goal last
+     * @return Returns false if there is no path, the waypoints are cleared
+     * then
+     */
+    bool Plan(const OccupancyGrid& map, double start_x, double start_y,
+              std::vector<double>& path_x, std::vector<double>& path_y);
+};
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * @file point_hough.h
+ * @brief Header file for the sparse point-voting Hough transform.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef POINT_HOUGH_H
+#define POINT_HOUGH_H
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "detect_helpers.h"
+#include "deadline.h"
+
+/**
+ * @brief Defines the PointHough class which finds circles by letting the
+ * laser points vote directly for circle centres.
+ *
+ * @details Instead of building and blurring an image and running the
+ * gradient Hough transform on it, every scan point votes into a compact
+ * accumulator that only spans the bounding box of the points. A point only
+ * votes along its estimated surface normal (pointing away from the robot),
+ * which plays the role of the image gradient in cv::HoughCircles and keeps
+ * straight walls from piling up votes. The ring offsets for every radius are
+ * precomputed and sorted by angle so the voting window is a table lookup.
+ *
+ * Usage:
+ *     PointHough point_hough;
+ *     point_hough.Detect(points, origin, hough_params, circles);
+ */
+class PointHough {
+private:
+    /**
+     * @brief Precomputed voting offsets for a single radius
+     */
+    struct RadiusOffsets {
+        /**
+         * @brief The radius in pixels
+         */
+        int radius_;
+
+        /**
+         * @brief Offsets of all the cells on the ring, sorted by angle
+         */
+        std::vector<cv::Point> offsets_;
+
+        /**
+         * @brief Index of the first offset with an angle of at least i degrees
+         */
+        std::vector<int> angle_start_;
+    };
+
+    /**
+     * @brief Votes for a range of radii, defined in the implementation file
+     */
+    class VoteBody;
+
+    /**
+     * @brief Offsets for every radius in [min_radius_, max_radius_]
+     */
+    std::vector<RadiusOffsets> rings_;
+
+    /**
+     * @brief Smallest radius the offsets were computed for
+     */
+    int min_radius_;
+
+    /**
+     * @brief Largest radius the offsets were computed for
+     */
+    int max_radius_;
+
+    /**
+     * @brief Recomputes the ring offsets if the radius range has changed
+     *
+     * @param min_radius The minimum radius to be detected
+     * @param max_radius The maximum radius to be detected
+     */
+    void PrecomputeOffsets(int min_radius, int max_radius);
+
+    /**
+     * @brief Estimates the outward normal direction of every point from its
+     * neighbours in scan order
+     *
+     * @param points The points in screen coordinates and scan order
+     * @param origin The position of the robot in screen coordinates
+     * @param max_gap Neighbours further apart than this belong to different
+     * objects
+     * @param normal_angles Filled with the angle of the normal in degrees, or
+     * -1 if the normal could not be estimated
+     */
+    void EstimateNormals(const std::vector<cv::Point2f>& points,
+                         const cv::Point2f& origin, float max_gap,
+                         std::vector<int>& normal_angles);
+
+public:
+    /**
+     * @brief Default constructor for PointHough
+     */
+    PointHough();
+
+    /**
+     * @brief Finds circles among the points
+     *
+     * @details The output has the same format as cv::HoughCircles: centre x,
+     * centre y and radius in screen coordinates, ordered by decreasing number
+     * of votes. Centres closer than min_dist_ to a stronger circle are dropped.
+     * Every radius is voted on its own. Once the deadline has expired the
+     * radii not yet started are skipped and the circles of the voted radii are
+     * returned.
+     *
+     * @param points The points in screen coordinates and scan order
+     * @param origin The position of the robot in screen coordinates
+     * @param params threshold_2_, min_dist_, min_radius_ and max_radius_ are used
+     * @param circles Filled with the detected circles
+     * @param deadline When to stop voting
+     * @return Returns false if radii were skipped because of the deadline
+     */
+    bool Detect(const std::vector<cv::Point2f>& points, const cv::Point2f& origin,
+                const HoughParams& params, std::vector<cv::Vec3f>& circles,
+                const Deadline& deadline = Deadline());
+};
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file polar_matcher.h
+ * @brief Header file for the circle detector that matches range profile
+ * templates in polar space.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef POLAR_MATCHER_H
+#define POLAR_MATCHER_H
+
+#include <vector>
+#include "circle_fit.h"
+#include "deadline.h"
+
+/**
+ * @brief Defines the PolarMatch structure which describes a circle found in
+ * the range profile, in the polar coordinates of the scan
+ */
+struct PolarMatch {
+    /**
+     * @brief Fractional beam index pointing at the centre of the circle
+     */
+    float index_;
+
+    /**
+     * @brief Distance from the laser to the centre of the circle in metres
+     */
+    float distance_;
+
+    /**
+     * @brief Radius of the circle in metres
+     */
+    float radius_;
+
+    /**
+     * @brief Root mean square distance of the beams from the fitted circle
+     */
+    float residual_;
+};
+
+/**
+ * @brief Defines the PolarMatcher class which finds circles directly in the
+ * ranges of a laser scan, without building a Cartesian image.
+ *
+ * @details A circle of radius r whose centre is d away leaves a dip in the
+ * range profile whose shape only depends on r and d. The profiles are
+ * precomputed for a grid of radii and distances. Every local range minimum is
+ * compared against the profiles of all radii at the matching distance and the
+ * best match is confirmed with a geometric circle fit of the beams under it.
+ *
+ * Usage:
+ *     PolarMatcher polar_matcher;
+ *     polar_matcher.Match(ranges, angle_increment, 0.15, 0.3, 2, 0.01, matches);
+ */
+class PolarMatcher {
+private:
+    /**
+     * @brief Precomputed range profile of a circle
+     */
+    struct Template {
+        /**
+         * @brief Number of beams on each side of the centre beam
+         */
+        int half_width_;
+
+        /**
+         * @brief Range of every beam minus the range of the centre beam
+         */
+        std::vector<float> profile_;
+    };
+
+    /**
+     * @brief Templates indexed by [radius][distance bin]
+     */
+    std::vector<std::vector<Template> > templates_;
+
+    /**
+     * @brief The radii of the templates in metres
+     */
+    std::vector<float> radii_;
+
+    /**
+     * @brief The angle between two beams the templates were computed for,
+     * and the radii and range they cover
+     */
+    double angle_increment_, min_radius_, max_radius_, max_range_;
+
+    /**
+     * @brief Recomputes the templates if they do not cover the parameters.
+     * The templates grow to cover every range and radius asked for so far,
+     * so the bands and the narrowed radius range of a tracked circle only
+     * use a part of them
+     */
+    void PrecomputeTemplates(double angle_increment, double min_radius,
+                             double max_radius, double max_range);
+
+    /**
+     * @brief Root mean square difference of the ranges around a beam and a
+     * template
+     *
+     * @return Returns a negative value if the template does not fit the scan
+     */
+    float Compare(const std::vector<float>& ranges, int index,
+                  const Template& circle_template);
+
+public:
+    /**
+     * @brief Default constructor for PolarMatcher
+     */
+    PolarMatcher();
+
+    /**
+     * @brief Finds circles in the range profile
+     *
+     * @param ranges The ranges from the laser range finder
+     * @param angle_increment The angle between two beams in radians
+     * @param min_radius The minimum radius to be detected in metres
+     * @param max_radius The maximum radius to be detected in metres
+     * @param max_range Beams further away than this are ignored
+     * @param max_error Maximum root mean square error of a match in metres
+     * @param matches Filled with the circles, best fit first. Circles whose
+     * dips overlap a better one are dropped
+     * @param deadline When to stop. The beams not yet examined are skipped and
+     * the matches found so far are returned
+     * @return Returns false if beams were skipped because of the deadline
+     */
+    bool Match(const std::vector<float>& ranges, double angle_increment,
+               double min_radius, double max_radius, double max_range,
+               double max_error, std::vector<PolarMatch>& matches,
+               const Deadline& deadline = Deadline());
+};
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file pose_helpers.h
+ * @brief Declares helpers to work with planar robot poses from odometry
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef POSE_HELPERS_H
+#define POSE_HELPERS_H
+
+#include <deque>
+
+/**
+ * @brief Defines the Pose2D structure which describes the position and
+ * heading of the robot in the plane, in the usual ROS convention (x forward,
+ * y to the left, theta counterclockwise)
+ */
+struct Pose2D {
+    /**
+     * @brief x coordinate in metres
+     */
+    double x_;
+
+    /**
+     * @brief y coordinate in metres
+     */
+    double y_;
+
+    /**
+     * @brief Heading in radians
+     */
+    double theta_;
+};
+
+/**
+ * @brief Builds a pose from its coordinates
+ *
+ * @param x x coordinate in metres
+ * @param y y coordinate in metres
+ * @param theta Heading in radians
+ * @return Returns the pose
+ */
+Pose2D MakePose(double x, double y, double theta);
+
+/**
+ * @brief Wraps an angle to [-pi, pi)
+ *
+ * @param angle The angle in radians
+ * @return Returns the wrapped angle
+ */
+double NormaliseAngle(double angle);
+
+/**
+ * @brief Extracts the heading from a quaternion describing a planar rotation
+ *
+ * @return Returns the rotation around the z axis in radians
+ */
+double YawFromQuaternion(double x, double y, double z, double w);
+
+/**
+ * @brief Computes where the robot went from one pose to the next, as seen
+ * from the first pose
+ *
+ * @param from The earlier pose
+ * @param to The later pose
+ * @return Returns the later pose in the frame of the earlier one
+ */
+Pose2D RelativePose(const Pose2D& from, const Pose2D& to);
+
+/**
+ * @brief Moves a pose on by a motion seen from it, the reverse of
+ * RelativePose
+ *
+ * @param from The earlier pose
+ * @param motion The motion in the frame of the earlier pose
+ * @return Returns the later pose
+ */
+Pose2D ComposePose(const Pose2D& from, const Pose2D& motion);
+
+/**
+ * @brief Computes the motion of the LRF from the motion of the robot. The
+ * LRF sits in front of the centre the robot turns around, so a turn moves it
+ * sideways as well
+ *
+ * @param motion The motion of the robot, as returned by RelativePose
+ * @param laser_offset Distance of the LRF in front of the centre the robot
+ * turns around, in metres
+ * @return Returns the motion of the LRF as seen from the LRF before it
+ */
+Pose2D LaserMotion(const Pose2D& motion, double laser_offset);
+
+/**
+ * @brief Moves a point that was seen from the robot into the frame of the
+ * robot after it has moved
+ *
+ * @param motion The motion of the robot, as returned by RelativePose
+ * @param x The x coordinate of the point, changed in place
+ * @param y The y coordinate of the point, changed in place
+ */
+void TransformToMovedFrame(const Pose2D& motion, double& x, double& y);
+
+/**
+ * @brief Defines the PoseHistory class which keeps the odometry poses of the
+ * last seconds to tell where the robot was when a measurement was taken.
+ *
+ * @details Poses have to be added in time order. Between two poses the pose
+ * is interpolated, after the newest one the newest one is used.
+ *
+ * Usage:
+ *     history.Add(msg->header.stamp.toSec(), pose);
+ *     history.PoseAt(detection_stamp, pose);
+ */
+class PoseHistory {
+private:
+    /**
+     * @brief Time stamps of the poses in seconds, oldest first
+     */
+    std::deque<double> stamps_;
+
+    /**
+     * @brief The poses belonging to stamps_
+     */
+    std::deque<Pose2D> poses_;
+
+    /**
+     * @brief Poses older than this many seconds before the newest are
+     * forgotten
+     */
+    double span_;
+
+public:
+    /**
+     * @brief Constructor for PoseHistory
+     *
+     * @param span The time in seconds the poses are kept for
+     */
+    explicit PoseHistory(double span);
+
+    /**
+     * @brief Adds the newest pose. A pose older than the newest one clears
+     * the history first, as the clock has jumped back
+     */
+    void Add(double stamp, const Pose2D& pose);
+
+    /**
+     * @brief Finds the pose of the robot at a time
+     *
+     * @param stamp The time in seconds
+     * @param pose Set to the pose at that time
+     * @return Returns false if the history is empty or does not reach back
+     * to the time, pose is left unchanged then
+     */
+    bool PoseAt(double stamp, Pose2D& pose) const;
+};
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file scan_deskew.h
+ * @brief Header file for the correction of the motion of the robot during a
+ * laser sweep.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef SCAN_DESKEW_H
+#define SCAN_DESKEW_H
+
+#include <sensor_msgs/LaserScan.h>
+#include <vector>
+
+/**
+ * @brief Defines the ScanDeskewer class which moves every beam of a scan to
+ * where it would have been seen from the pose at the end of the sweep.
+ *
+ * @details The beams of a sweep are taken one after another, time_increment
+ * apart, so a moving robot bends walls and circles in the scan. Assuming a
+ * constant twist during the sweep, every beam is turned into a point,
+ * transformed by the motion between its own time and the end of the sweep
+ * and put back into the beam its new angle falls into. The LRF sits in front
+ * of the centre the robot turns around, so a turn in place moves it as well.
+ * The motion of a sweep
+ * is a small angle, so it is expanded into a polynomial instead of calling
+ * sin and cos per beam, which keeps the transform loop free of calls and lets
+ * the compiler vectorise it. Beams without a return are left in place. A
+ * beam that receives no point is interpolated from its neighbours if they
+ * lie on the same surface and keeps its measured range otherwise.
+ *
+ * Usage:
+ *     ScanDeskewer deskewer;
+ *     deskewer.SetParams(0.15);
+ *     deskewer.Deskew(*msg, linear_velocity, angular_velocity, ranges);
+ */
+class ScanDeskewer {
+private:
+    /**
+     * @brief Cosine and sine of every beam angle
+     */
+    std::vector<float> cos_, sin_;
+
+    /**
+     * @brief The beam layout cos_ and sin_ were computed for
+     */
+    float angle_min_, angle_increment_;
+
+    /**
+     * @brief The beams as points in the frame at the end of the sweep
+     */
+    std::vector<float> x_, y_;
+
+    /**
+     * @brief Distance of the LRF in front of the centre the robot turns
+     * around, in metres
+     */
+    double laser_offset_;
+
+    /**
+     * @brief Recomputes the beam directions if the beam layout has changed
+     */
+    void PrecomputeAngles(float angle_min, float angle_increment, size_t size);
+
+public:
+    /**
+     * @brief Default constructor for ScanDeskewer
+     */
+    ScanDeskewer();
+
+    /**
+     * @brief Sets the parameters of the deskewer
+     *
+     * @param laser_offset Distance of the LRF in front of the centre the
+     * robot turns around, in metres
+     */
+    void SetParams(double laser_offset);
+
+    /**
+     * @brief Corrects the ranges of a scan for the motion of the robot
+     *
+     * @details Without time_increment the beams are assumed to be spread
+     * over a full revolution of scan_time.
+     *
+     * @param scan The scan as measured
+     * @param linear_velocity The forward velocity of the robot in metres per
+     * second during the sweep
+     * @param angular_velocity The turn rate of the robot in radians per
+     * second during the sweep, counterclockwise positive
+     * @param ranges Filled with the ranges seen from the pose at the end of
+     * the sweep, in the beam layout of the scan
+     * @return Returns false if the scan has no timing or the robot stood
+     * still, in which case the ranges are copied unchanged
+     */
+    bool Deskew(const sensor_msgs::LaserScan& scan, double linear_velocity,
+                double angular_velocity, std::vector<float>& ranges);
+};
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * @file scan_matcher.h
+ * @brief Header file for the estimation of the motion of the robot from two
+ * consecutive laser scans.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef SCAN_MATCHER_H
+#define SCAN_MATCHER_H
+
+#include <vector>
+#include "pose_helpers.h"
+
+/**
+ * @brief Defines the ScanMatcher class which finds the motion of the robot
+ * between a reference scan and a new one with point-to-line ICP.
+ *
+ * @details The points of the reference scan get the normal of the line
+ * through their neighbours and are sorted into a grid with cells of
+ * max_match_distance_, so the closest reference point of a new point is
+ * found among the points of 3 x 3 cells. Every iteration moves the new
+ * points by the current estimate, pairs them with their closest reference
+ * points and solves the linearised least squares problem of their distances
+ * to the lines of those points. The sums of that problem are taken in one
+ * loop over plain float arrays without branches, which the compiler
+ * vectorises.
+ *
+ * Usage:
+ *     matcher.SetReference(ranges, angle_min, angle_increment, range_min, range_max);
+ *     if (matcher.Match(ranges, angle_min, angle_increment, range_min, range_max,
+ *                       guess, motion)) { ... }
+ */
+class ScanMatcher {
+private:
+    /**
+     * @brief Most iterations of a match
+     */
+    int max_iterations_;
+
+    /**
+     * @brief Points further apart than this in metres are not paired
+     */
+    double max_match_distance_;
+
+    /**
+     * @brief Points of the reference scan and the normals of their lines
+     */
+    std::vector<float> ref_x_, ref_y_, normal_x_, normal_y_;
+
+    /**
+     * @brief Lower corner of the grid, the side of its cells and its size in
+     * cells. The cells are max_match_distance_ wide unless that makes too
+     * many of them
+     */
+    float grid_x_, grid_y_, cell_size_;
+    int grid_width_, grid_height_;
+
+    /**
+     * @brief The reference points sorted by grid cell, with the first point
+     * of every cell in cell_start_ and one entry past the last cell
+     */
+    std::vector<int> cell_start_, cell_points_;
+
+    /**
+     * @brief Points of the scan being matched, as seen and as moved by the
+     * estimate
+     */
+    std::vector<float> x_, y_, moved_x_, moved_y_;
+
+    /**
+     * @brief Pairing of the moved points: a weight of 1 if a partner was
+     * found and 0 otherwise, the normal of the partner's line and the
+     * distance of that line from the origin along the normal
+     */
+    std::vector<float> weight_, match_normal_x_, match_normal_y_, match_offset_;
+
+    /**
+     * @brief Turns the valid ranges of a scan into points
+     */
+    static void ScanToPoints(const std::vector<float>& ranges, double angle_min,
+                             double angle_increment, double range_min, double range_max,
+                             std::vector<float>& x, std::vector<float>& y);
+
+    /**
+     * @brief Finds the closest reference point within max_match_distance_
+     *
+     * @return Returns its index or -1 if there is none
+     */
+    int ClosestReference(float x, float y) const;
+
+public:
+    /**
+     * @brief Default constructor for ScanMatcher, without a reference scan
+     */
+    ScanMatcher();
+
+    /**
+     * @brief Sets the parameters of the matching
+     *
+     * @param max_iterations Most iterations of a match
+     * @param max_match_distance Points further apart than this in metres are
+     * not paired
+     */
+    void SetParams(int max_iterations, double max_match_distance);
+
+    /**
+     * @brief Makes a scan the reference the next scans are matched against
+     *
+     * @param ranges The ranges of the scan
+     * @param angle_min Angle of the first beam, counterclockwise from forward
+     * @param angle_increment Angle between two beams
+     * @param range_min Shorter ranges are invalid
+     * @param range_max Ranges from this on saw nothing
+     */
+    void SetReference(const std::vector<float>& ranges, double angle_min,
+                      double angle_increment, double range_min, double range_max);
+
+    /**
+     * @brief Returns true if there is a reference scan with enough points
+     */
+    bool HasReference() const;
+
+    /**
+     * @brief Finds the motion of the robot from the reference scan to a new
+     * scan
+     *
+     * @param ranges, angle_min, angle_increment, range_min, range_max The
+     * new scan, as for SetReference
+     * @param guess The expected motion, where the search starts
+     * @param motion Set to the pose of the new scan in the frame of the
+     * reference scan, in the usual ROS convention
+     * @return Returns false if the scans have too little in common to be
+     * matched, motion is left unchanged then
+     */
+    bool Match(const std::vector<float>& ranges, double angle_min, double angle_increment,
+               double range_min, double range_max, const Pose2D& guess, Pose2D& motion);
+};
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @file scan_odometry.h
+ * @brief This file defines the ScanOdometry class
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef SCAN_ODOMETRY_H
+#define SCAN_ODOMETRY_H
+
+#include <ros/ros.h>
+#include <sensor_msgs/LaserScan.h>
+#include <nav_msgs/Odometry.h>
+#include "pose_helpers.h"
+#include "scan_matcher.h"
+
+/**
+ * @brief Defines the odometry of the robot from its laser scans. Every scan
+ * is matched against the one before it and the motions add up to a pose
+ * that is published like the odometry of the robot, at the rate of the scans
+ *
+ * Usage:
+ *     ScanOdometry scan_odometry;
+ */
+class ScanOdometry {
+
+private:
+
+	/**
+	 * @brief Ros node to which the class is attached
+	 */
+	ros::NodeHandle node_;
+
+	/**
+	 * @brief Used to get the data from the laser range finder
+	 */
+	ros::Subscriber laser_sub_;
+
+	/**
+	 * @brief Used to publish the odometry found from the scans
+	 */
+	ros::Publisher odom_pub_;
+
+	/**
+	 * @brief Finds the motion between two consecutive scans
+	 */
+	ScanMatcher matcher_;
+
+	/**
+	 * @brief The pose of the robot in the frame of its first scan
+	 */
+	Pose2D pose_;
+
+	/**
+	 * @brief Motion between the last two scans, where the next match starts
+	 */
+	Pose2D last_motion_;
+
+	/**
+	 * @brief Stamp of the last scan, to turn the motions into velocities
+	 */
+	ros::Time last_stamp_;
+
+	/**
+	 * @brief Loads the parameters of the matching and connects the topics
+	 */
+	void Initialise();
+
+public:
+
+	/**
+	 * @brief Default constructor for ScanOdometry, at the origin
+	 */
+	ScanOdometry();
+
+	/**
+	 * @brief Matches a new scan against the last one and publishes the
+	 * resulting pose
+	 *
+	 * @param msg The new scan
+	 */
+	void LaserCallback(const sensor_msgs::LaserScan::ConstPtr& msg);
+
+	/**
+	 * @brief The pose of the robot in the frame of its first scan
+	 */
+	Pose2D get_pose() {
+		return pose_;
+	}
+};
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file split_hough.h
+ * @brief Header file for the Hough transform split into parallel jobs.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef SPLIT_HOUGH_H
+#define SPLIT_HOUGH_H
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "detect_helpers.h"
+#include "deadline.h"
+
+/**
+ * @brief Defines the HoughJob structure which is a part of the radius range
+ * searched in a tile of the image
+ */
+struct HoughJob {
+    /**
+     * @brief The part of the image the Hough transform runs on
+     */
+    cv::Rect tile_;
+
+    /**
+     * @brief The part of the tile the job reports centres for. The cores of
+     * all tiles cover the window without overlap
+     */
+    cv::Rect core_;
+
+    /**
+     * @brief The smallest radius in pixels
+     */
+    int min_radius_;
+
+    /**
+     * @brief The largest radius in pixels
+     */
+    int max_radius_;
+};
+
+/**
+ * @brief Splits a Hough search into jobs
+ *
+ * @details The radius range is cut into parts that overlap by a pixel. The
+ * window is cut into cores, and each tile is its core grown by the largest
+ * radius and the reach of the edge detector, so every edge point that votes
+ * for a centre in the core lies within the tile.
+ *
+ * @param window The part of the image to search
+ * @param params The Hough parameters
+ * @param split How to split the search
+ * @param jobs Filled with the jobs, the tiles of the first radius part first
+ */
+void PlanHoughJobs(const cv::Rect& window, const HoughParams& params,
+                   const SplitParams& split, std::vector<HoughJob>& jobs);
+
+/**
+ * @brief Mean brightness of the image along a circle, used to rank circles
+ * found by different jobs
+ *
+ * @param image The blurred image of the scan
+ * @param circle The circle in image coordinates
+ * @return The mean pixel value of the ring, 0 outside the image
+ */
+float RingSupport(const cv::Mat& image, const cv::Vec3f& circle);
+
+/**
+ * @brief Merges the circles of all jobs by non maximum suppression
+ *
+ * @param image The blurred image of the scan
+ * @param results The circles of every job in image coordinates
+ * @param min_dist The smallest distance in pixels between two kept centres
+ * @param circles Filled with the merged circles, best supported first
+ */
+void MergeCircles(const cv::Mat& image, const std::vector<std::vector<cv::Vec3f> >& results,
+                  int min_dist, std::vector<cv::Vec3f>& circles);
+
+/**
+ * @brief Runs cv::HoughCircles as independent jobs in parallel and merges
+ * their circles. The jobs are run with cv::parallel_for_, so the result does
+ * not depend on the number of threads
+ *
+ * @param image The blurred image of the scan
+ * @param window The part of the image to search
+ * @param params The Hough parameters
+ * @param split How to split the search
+ * @param circles Filled with the circles in image coordinates
+ * @param deadline When to stop. Jobs not yet started are skipped and the
+ * circles of the finished jobs are merged
+ * @return Returns false if jobs were skipped because of the deadline
+ */
+bool SplitHoughCircles(const cv::Mat& image, const cv::Rect& window,
+                       const HoughParams& params, const SplitParams& split,
+                       std::vector<cv::Vec3f>& circles,
+                       const Deadline& deadline = Deadline());
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file spsc_queue.h
+ * @brief Bounded lock-free queue between a single producer and a single
+ * consumer thread.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Defines the SpscQueue class, a ring buffer of fixed capacity that
+ * one thread pushes to and one other thread pops from without locking.
+ *
+ * @details Only the producer moves the tail and only the consumer moves the
+ * head, so each index has a single writer. The release store of an index
+ * publishes the slot it passes over to the other thread. One slot is always
+ * left empty to tell a full ring from an empty one. Neither call blocks; a
+ * full or empty queue is reported to the caller.
+ *
+ * Usage:
+ *     producer: if (!queue.TryPush(value)) { drop or retry }
+ *     consumer: while (queue.TryPop(value)) { use value }
+ */
+template <typename T>
+class SpscQueue {
+private:
+    /**
+     * @brief The ring, one slot larger than the capacity
+     */
+    std::vector<T> slots_;
+
+    /**
+     * @brief Index of the next slot to pop, written by the consumer only
+     */
+    std::atomic<size_t> head_;
+
+    /**
+     * @brief Index of the next slot to push, written by the producer only
+     */
+    std::atomic<size_t> tail_;
+
+    SpscQueue(const SpscQueue&);
+    SpscQueue& operator=(const SpscQueue&);
+
+public:
+    /**
+     * @brief Creates an empty queue
+     *
+     * @param capacity The number of values the queue holds at most
+     */
+    explicit SpscQueue(size_t capacity) : slots_(capacity + 1), head_(0), tail_(0) {
+    }
+
+    /**
+     * @brief Adds a value at the back. Called by the producer only
+     *
+     * @param value The value to add
+     * @return Returns false if the queue is full, in which case nothing is added
+     */
+    bool TryPush(const T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) % slots_.size();
+        if (next == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slots_[tail] = value;
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the value at the front. Called by the consumer only
+     *
+     * @param value Set to the removed value
+     * @return Returns false if the queue is empty, in which case value is
+     * left unchanged
+     */
+    bool TryPop(T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = slots_[head];
+        head_.store((head + 1) % slots_.size(), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief The number of values the queue holds at most
+     */
+    size_t Capacity() const {
+        return slots_.size() - 1;
+    }
+};
+
+#endif
@@ -36,4 +36,75 @@ double Min(double right_min_distance, double left_min_distance,
  */
 double GetMin(std::vector<float>& ranges, int start, int finish);
 
+/**
+ * @brief Method to get the curvature of the arc from the robot to a point,
+ * starting in the direction the robot is heading (pure pursuit)
+ *
+ * @param forward Distance of the point in front of the robot
+ * @param left Distance of the point to the left of the robot
+ * @return Returns the curvature in 1/metres, positive for a left turn and 0
+ * for the point itself
+ */
+double PursuitCurvature(double forward, double left);
+
+/**
+ * @brief Method to get the velocities that drive the robot on the arc to a
+ * point, turning in place first if the point is not in front. A tight arc is
+ * driven slower rather than cut short
+ *
+ * @param forward Distance of the point in front of the robot
+ * @param left Distance of the point to the left of the robot
+ * @param max_angular_velocity Angular velocity the robot never goes above
+ * @param linear_velocity The velocity on a straight way, set to the velocity
+ * on the arc
+ * @param angular_velocity Set to the angular velocity, positive for a left
+ * turn
+ */
+void ArcVelocities(double forward, double left, double max_angular_velocity,
+                   double& linear_velocity, double& angular_velocity);
+
+/**
+ * @brief Method to get the velocity from which the robot can still stop
+ * within a distance
+ *
+ * @param free_distance Distance the robot can still move
+ * @param min_velocity Velocity the robot never goes below
+ * @param max_velocity Velocity the robot never goes above
+ * @param deceleration Deceleration of the robot when it brakes
+ * @return Returns the velocity, between min_velocity and max_velocity
+ */
+double ApproachVelocity(double free_distance, double min_velocity,
+                        double max_velocity, double deceleration);
+
+/**
+ * @brief Method to turn the ranges of the laser range finder into points,
+ * with x to the right and y forward like the circle coordinates. The ranges
+ * span 240 degrees starting 30 degrees behind the right side
+ *
+ * @param ranges ranges of data in the laser range finder
+ * @param x Filled with the x coordinates of the points
+ * @param y Filled with the y coordinates of the points
+ */
+void ScanToPoints(const std::vector<float>& ranges, std::vector<float>& x,
+                  std::vector<float>& y);
+
+/**
+ * @brief Method to get how far the robot can drive straight towards a goal
+ * before it runs into one of the points
+ *
+ * @details The robot sweeps a rectangle of its width from where it is to
+ * the goal. Of the points inside the rectangle the one closest to the robot
+ * along the way decides the free distance.
+ *
+ * @param x The x coordinates of the points
+ * @param y The y coordinates of the points
+ * @param goal_x The x coordinate of the goal
+ * @param goal_y The y coordinate of the goal
+ * @param half_width Half of the width of the robot
+ * @return Returns the distance along the way to the first point in the
+ * rectangle, or the distance to the goal if there is none
+ */
+double CorridorFreeDistance(const std::vector<float>& x, const std::vector<float>& y,
+                            double goal_x, double goal_y, double half_width);
+
 #endif
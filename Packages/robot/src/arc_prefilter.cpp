@@ -0,0 +1,149 @@
+/**
+ * @file arc_prefilter.cpp
+ * @brief Defines the prefilter that checks a laser scan for arcs
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "arc_prefilter.h"
+#include "detect_helpers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Number of neighbours on each side the points are averaged over to
+// suppress the range noise before the curvature is computed
+const int smoothing = 2;
+
+// Counted up to no further, so the count cannot overflow
+const int max_scans_since_arc = 1000000;
+
+}
+
+bool HasArcCandidate(const std::vector<float>& ranges, double angle_min,
+                     double angle_increment, const ArcParams& params) {
+    int size = static_cast<int>(ranges.size());
+    if (size < 3 || angle_increment <= 0) {
+        return false;
+    }
+
+    // Cartesian points and the segment each beam belongs to, -1 if invalid
+    std::vector<float> x(size), y(size);
+    std::vector<int> segment_end(size, -1);
+    int start = -1;
+    for (int i = 0; i <= size; ++i) {
+        bool valid = i < size && std::isfinite(ranges[i]) && ranges[i] > 0
+                     && ranges[i] < params.max_range_;
+        bool split = !valid || (start >= 0
+                                && std::fabs(ranges[i] - ranges[i - 1]) > params.jump_distance_);
+        if (split && start >= 0) {
+            for (int j = start; j < i; ++j) {
+                segment_end[j] = i - 1;
+            }
+            start = -1;
+        }
+        if (valid) {
+            double angle = angle_min + i * angle_increment;
+            x[i] = ranges[i] * std::cos(angle);
+            y[i] = ranges[i] * std::sin(angle);
+            if (start < 0) {
+                start = i;
+            }
+        }
+    }
+
+    // Moving average inside each segment, computed from prefix sums
+    std::vector<double> sum_x(size + 1, 0), sum_y(size + 1, 0);
+    for (int i = 0; i < size; ++i) {
+        sum_x[i + 1] = sum_x[i] + (segment_end[i] < 0 ? 0 : x[i]);
+        sum_y[i + 1] = sum_y[i] + (segment_end[i] < 0 ? 0 : y[i]);
+    }
+    std::vector<float> smooth_x(size), smooth_y(size);
+    int first = 0;
+    for (int i = 0; i < size; ++i) {
+        if (segment_end[i] < 0) {
+            continue;
+        }
+        if (i == 0 || segment_end[i - 1] != segment_end[i]) {
+            first = i;
+        }
+        int low = std::max(first, i - smoothing);
+        int high = std::min(segment_end[i], i + smoothing);
+        smooth_x[i] = (sum_x[high + 1] - sum_x[low]) / (high - low + 1);
+        smooth_y[i] = (sum_y[high + 1] - sum_y[low]) / (high - low + 1);
+    }
+    x.swap(smooth_x);
+    y.swap(smooth_y);
+
+    // Length and radius bounds of the current run of convex triples
+    int run = 0;
+    float run_min_radius = 0, run_max_radius = 0;
+    int segment_start = 0;
+    for (int i = 0; i < size; ++i) {
+        if (segment_end[i] < 0) {
+            run = 0;
+            continue;
+        }
+        if (i == 0 || segment_end[i - 1] != segment_end[i]) {
+            segment_start = i;
+            run = 0;
+        }
+
+        // Spread the triple over about twice the smallest radius so the
+        // sagitta of an arc stands out of the noise
+        int stride = std::max(2, static_cast<int>(params.min_radius_
+                                                  / (ranges[i] * angle_increment)));
+        if (i - stride < segment_start || i + stride > segment_end[i]) {
+            run = 0;
+            continue;
+        }
+
+        float ax = x[i] - x[i - stride], ay = y[i] - y[i - stride];
+        float bx = x[i + stride] - x[i], by = y[i + stride] - y[i];
+        float cx = x[i + stride] - x[i - stride], cy = y[i + stride] - y[i - stride];
+        // The beams sweep counter clockwise, so a surface bulging towards the
+        // robot turns clockwise
+        float cross = ax * by - ay * bx;
+        float radius = std::sqrt((ax * ax + ay * ay) * (bx * bx + by * by) * (cx * cx + cy * cy))
+                       / (2 * std::fabs(cross) + 1e-12f);
+
+        if (cross >= 0 || radius < params.min_radius_ || radius > params.max_radius_) {
+            run = 0;
+            continue;
+        }
+
+        if (run == 0) {
+            run_min_radius = run_max_radius = radius;
+        } else {
+            run_min_radius = std::min(run_min_radius, radius);
+            run_max_radius = std::max(run_max_radius, radius);
+        }
+        ++run;
+
+        // An arc keeps about the same radius over half a stride, a corner
+        // does not
+        if (run_max_radius > 3 * run_min_radius) {
+            run = 1;
+            run_min_radius = run_max_radius = radius;
+        } else if (2 * run >= stride) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+ArcGate::ArcGate() : scans_since_arc_(max_scans_since_arc) {
+}
+
+bool ArcGate::Pass(bool has_arc, int scans) {
+    scans_since_arc_ = has_arc ? 0 : std::min(scans_since_arc_ + 1, max_scans_since_arc);
+    return scans_since_arc_ < scans;
+}
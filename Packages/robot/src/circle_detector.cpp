@@ -11,26 +11,82 @@
 
 #include "ros/ros.h"
 #include "sensor_msgs/LaserScan.h"
+#include "nav_msgs/Odometry.h"
+#include "std_msgs/Bool.h"
 #include "robot/circle_detect_msg.h"
 #include "circle_detector.h"
 #include "detect_helpers.h"
+#include "circle_fit.h"
+#include "split_hough.h"
+#include "circle_tracker.h"
+#include "local_point_map.h"
+#include "pose_helpers.h"
+#include "arc_prefilter.h"
 #include "logger.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <vector>
 
+namespace {
+
+// Seconds a pipeline stage sleeps when it has nothing to do
+const double pipeline_idle = 0.001;
+
+// Share of the tracked radius by which the radius search may deviate from it
+// once the governor narrows the search
+const double narrow_radius_share = 0.25;
+
+// Seconds of slack when keeping to the detection rate without a known scan
+// time
+const double min_rate_slack = 0.005;
+
+double Seconds(int64 start) {
+    return (cv::getTickCount() - start) / cv::getTickFrequency();
+}
+
+bool CompareConfidence(const robot::circle_candidate& a, const robot::circle_candidate& b) {
+    return a.confidence > b.confidence;
+}
+
+}
+
 //Define the constructor for the CircleDetector class
-CircleDetector::CircleDetector() : node_() {
+CircleDetector::CircleDetector() : node_(), splat_sigma_(0),
+    fit_iterations_(0), backend_(HOUGH_GRADIENT),
+    polar_max_error_(0), detection_budget_(0), load_level_(LOAD_NORMAL),
+    skip_count_(0), demanded_(true), idle_scan_stride_(0), idle_count_(0),
+    detection_rate_(0), have_odometry_(false), odom_linear_velocity_(0),
+    odom_angular_velocity_(0), deskew_scans_(false), laser_offset_(0),
+    local_map_scans_(1),
+    pipelined_(false), frames_(2), ready_frames_(2), free_frames_(2),
+    latest_have_odometry_(false), running_(false) {
+    odom_pose_ = MakePose(0, 0, 0);
+    track_state_.pose_ = odom_pose_;
+    track_state_.have_odometry_ = false;
+    track_state_.circle_distance_ = -1;
     LoadParams();
     LoadTopics();
+    StartPipeline();
+}
+
+CircleDetector::~CircleDetector() {
+    running_ = false;
+    if (raster_thread_.joinable()) {
+        raster_thread_.join();
+    }
+    if (detect_thread_.joinable()) {
+        detect_thread_.join();
+    }
 }
 
 void CircleDetector::LoadTopics() {
     bool loaded = true;
-    std::string laser_topic, circle_topic;
+    std::string laser_topic, circle_topic, odom_topic, demand_topic;
 
     if (!node_.getParam("laser_topic",
                         laser_topic)) {
@@ -42,6 +98,16 @@ void CircleDetector::LoadTopics() {
         loaded = false;
     }
 
+    if (!node_.getParam("odom_topic",
+                        odom_topic)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("demand_topic",
+                        demand_topic)) {
+        loaded = false;
+    }
+
     if (loaded == false) {
         ROS_INFO("Topics failed to load!");
         ros::shutdown();
@@ -50,10 +116,40 @@ void CircleDetector::LoadTopics() {
     //subscribe the node
     laser_sub_ = node_.subscribe(laser_topic, 100,
                                  &CircleDetector::LaserCallback, this);
+    //the tracker works without odometry, it just predicts worse
+    if (!odom_topic.empty()) {
+        odom_sub_ = node_.subscribe(odom_topic, 100,
+                                    &CircleDetector::OdomCallback, this);
+    }
+    //without a controller telling otherwise the detections are needed
+    if (!demand_topic.empty()) {
+        demand_sub_ = node_.subscribe(demand_topic, 1,
+                                      &CircleDetector::DemandCallback, this);
+    }
     circle_detect_pub_ = node_.advertise<robot::circle_detect_msg>(
                              circle_topic, 100);
 }
 
+void CircleDetector::StartPipeline() {
+    if (!node_.getParam("/pipelined",
+                        pipelined_)) {
+        ROS_INFO("Failed to load params!");
+        Logger::Instance().Log("Failed to load params",Logger::log_level_error);
+        ros::shutdown();
+    }
+    if (!pipelined_) {
+        return;
+    }
+
+    //both frames start out free for the rasterisation stage
+    for (size_t i = 0; i < frames_.size(); ++i) {
+        free_frames_.TryPush(&frames_[i]);
+    }
+    running_ = true;
+    raster_thread_ = std::thread(&CircleDetector::RasterLoop, this);
+    detect_thread_ = std::thread(&CircleDetector::DetectLoop, this);
+}
+
 //Define a method to convert the Cartesian coordinates to screen coordinates
 void CircleDetector::ConvertCartesianToScreen(int &x, int &y, int screen_w, int screen_h) {
     //convert the data of the x Cartesian coordinate to screen coordinate
@@ -64,12 +160,15 @@ void CircleDetector::ConvertCartesianToScreen(int &x, int &y, int screen_w, int
 
 //Define a method to convert the data received from the laser to Cartesian coordinates
 void CircleDetector::ConvertLaserScanToCartesian(int &x, int &y, float range, float base_scan_min_angle) {
-    //initialize the scale factor variable
-    const int scale_factor = 100;
+    ConvertLaserScanToCartesian(x, y, range, base_scan_min_angle, raster_params_.scale_factor_);
+}
+
+void CircleDetector::ConvertLaserScanToCartesian(int &x, int &y, float range, float angle,
+                                                 double scale) {
     //convert the data of the x coordinate to Cartesian coordinate
-    x = static_cast<int>((range * sin(base_scan_min_angle)) * scale_factor);
+    x = static_cast<int>((range * sin(angle)) * scale);
     //convert the data of the y coordinate to Cartesian coordinate
-    y = static_cast<int>((range * cos(base_scan_min_angle)) * scale_factor);
+    y = static_cast<int>((range * cos(angle)) * scale);
 }
 
 //Define a method which loads the parameters
@@ -118,6 +217,182 @@ void CircleDetector::LoadParams() {
         loaded = false;
     }
 
+    if (!node_.getParam("/hough_radius_splits",
+                        split_params_.radius_splits_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/hough_tiles",
+                        split_params_.tiles_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/circle_fit_iterations",
+                        fit_iterations_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/raster_scale",
+                        raster_params_.scale_factor_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/lrf_max_range",
+                        raster_params_.max_range_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/raster_bands",
+                        raster_params_.bands_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/raster_adaptive",
+                        raster_params_.adaptive_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/raster_coarse_scale",
+                        raster_params_.coarse_scale_factor_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/raster_fine_range",
+                        raster_params_.fine_range_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/prefilter_enabled",
+                        arc_params_.enabled_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/prefilter_jump_distance",
+                        arc_params_.jump_distance_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/polar_max_error",
+                        polar_max_error_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/detection_budget",
+                        detection_budget_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/governor_enabled",
+                        governor_params_.enabled_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/governor_overload",
+                        governor_params_.overload_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/governor_headroom",
+                        governor_params_.headroom_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/governor_smoothing",
+                        governor_params_.smoothing_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/governor_hold_frames",
+                        governor_params_.hold_frames_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/idle_scan_stride",
+                        idle_scan_stride_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/detection_rate",
+                        detection_rate_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/deskew_scans",
+                        deskew_scans_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/laser_offset",
+                        laser_offset_)) {
+        loaded = false;
+    }
+    deskewer_.SetParams(laser_offset_);
+    local_map_.SetLaserOffset(laser_offset_);
+
+    if (!node_.getParam("/tracking_enabled",
+                        track_params_.enabled_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/tracking_alpha",
+                        track_params_.alpha_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/tracking_beta",
+                        track_params_.beta_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/tracking_gate",
+                        track_params_.gate_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/tracking_window",
+                        track_params_.window_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/tracking_lock_hits",
+                        track_params_.lock_hits_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/tracking_max_misses",
+                        track_params_.max_misses_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/tracking_full_search_frames",
+                        track_params_.full_search_frames_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/local_map_scans",
+                        local_map_scans_)) {
+        loaded = false;
+    }
+
+    //Candidate arcs may be somewhat off the expected radius range
+    arc_params_.min_radius_ = 0.5 * hough_params_.min_radius_ / raster_params_.scale_factor_;
+    arc_params_.max_radius_ = 2.0 * hough_params_.max_radius_ / raster_params_.scale_factor_;
+    arc_params_.max_range_ = BandMaxRange(raster_params_.bands_ - 1);
+
+    std::string backend;
+    if (!node_.getParam("/detector_backend",
+                        backend)) {
+        loaded = false;
+    } else if (backend == "hough_gradient") {
+        backend_ = HOUGH_GRADIENT;
+    } else if (backend == "point_vote") {
+        backend_ = POINT_VOTE;
+    } else if (backend == "polar_template") {
+        backend_ = POLAR_TEMPLATE;
+    } else {
+        loaded = false;
+    }
+
     if (!loaded) {
         ROS_INFO("Failed to load params!");
         Logger::Instance().Log("Failed to load params",Logger::log_level_error);
@@ -125,93 +400,811 @@ void CircleDetector::LoadParams() {
     }
 }
 
-cv::Mat CircleDetector::CreateImage(const sensor_msgs::LaserScan::ConstPtr& msg) {
-    size_t data_points = msg->ranges.size();
+void CircleDetector::SelectResolution(int band, double circle_distance, bool coarse,
+                                      BandView& view) {
+    //Use the coarse scale unless a circle was recently seen close by
+    view.band_ = band;
+    view.backend_ = backend_;
+    view.radius_ = 0;
+    view.scale_ = raster_params_.scale_factor_;
+    if (raster_params_.adaptive_ && (circle_distance < 0
+                                     || circle_distance > raster_params_.fine_range_)) {
+        view.scale_ = raster_params_.coarse_scale_factor_;
+    }
+    if (coarse) {
+        view.scale_ /= 2;
+    }
+
+    //Every band reaches twice as far at half the scale, so all bands use an
+    //image of the same size. Neighbouring bands overlap by a circle so that
+    //circles on the border are whole in one of them
+    view.scale_ /= 1 << band;
+    view.max_range_ = BandMaxRange(band);
+    view.min_range_ = 0;
+    if (band > 0) {
+        view.min_range_ = BandMaxRange(band - 1)
+                          - 2 * hough_params_.max_radius_ / raster_params_.scale_factor_;
+    }
+
+    //Leave room for the blur footprint and for centres of circles at the edge of the range
+    double ratio = view.scale_ / raster_params_.scale_factor_;
+    int margin = static_cast<int>(std::ceil((blur_params_.kernel_size_ + hough_params_.max_radius_)
+                                            * ratio)) + 1;
+    int side = 2 * (static_cast<int>(std::ceil(view.max_range_ * view.scale_)) + margin);
+    view.screen_ = cv::Size(side, side);
+    view.window_ = cv::Rect(0, 0, side, side);
+}
+
+double CircleDetector::BandMaxRange(int band) {
+    return raster_params_.max_range_ * (1 << std::max(0, band));
+}
+
+int CircleDetector::BandOf(double distance) {
+    int band = 0;
+    while (band < raster_params_.bands_ - 1 && distance >= BandMaxRange(band)) {
+        ++band;
+    }
+    return band;
+}
 
-    //create image
-    int screen_width = 1000;
-    int screen_height = 1000;
-    const float lrf_max_range = 2;
+HoughParams CircleDetector::ScaledHoughParams(const BandView& view) {
+    //The parameters are given at the fine scale, so shrink them with the image
+    double ratio = view.scale_ / raster_params_.scale_factor_;
+    HoughParams params = hough_params_;
+    params.min_dist_ = std::max(1, static_cast<int>(hough_params_.min_dist_ * ratio));
+    params.min_radius_ = std::max(1, static_cast<int>(hough_params_.min_radius_ * ratio));
+    params.max_radius_ = std::max(params.min_radius_,
+                                  static_cast<int>(std::ceil(hough_params_.max_radius_ * ratio)));
+    if (view.radius_ > 0) {
+        //only look for circles about as large as the tracked one
+        double radius = view.radius_ * view.scale_;
+        int low = static_cast<int>(radius * (1 - narrow_radius_share));
+        int high = static_cast<int>(std::ceil(radius * (1 + narrow_radius_share)));
+        params.min_radius_ = std::max(params.min_radius_, low);
+        params.max_radius_ = std::max(params.min_radius_, std::min(params.max_radius_, high));
+    }
+    //The gradient accumulator grows with the number of pixels on the circle
+    //while the point votes do not depend on the resolution
+    if (view.backend_ == HOUGH_GRADIENT) {
+        params.threshold_2_ = std::max(1, static_cast<int>(hough_params_.threshold_2_ * ratio));
+    } else {
+        //but fewer beams hit a circle the further away it is
+        double band_ratio = raster_params_.max_range_ / view.max_range_;
+        params.threshold_2_ = std::max(3, static_cast<int>(hough_params_.threshold_2_ * band_ratio));
+    }
+    return params;
+}
+
+void CircleDetector::CreateImage(const sensor_msgs::LaserScan::ConstPtr& msg,
+                                 const BandView& view, cv::Mat& image) {
+    size_t data_points = msg->ranges.size();
 
-    cv::Mat image(screen_width, screen_height, CV_8UC1, Scalar(0));
+    //create image, keeping the memory of the previous one
+    image.create(view.screen_.height, view.screen_.width, CV_8UC1);
+    image.setTo(Scalar(0));
+    UpdateSplatKernel(view);
 
     //convert laser_scan data to image
     float base_scan_min_angle = msg->angle_min;
+    int last_x = -1, last_y = -1;
     for (int i = 0; i < data_points; ++i) {
         float range = msg->ranges[data_points - 1 - i];
         base_scan_min_angle += msg->angle_increment;
-        if (range < lrf_max_range) {
+        if (range >= view.min_range_ && range < view.max_range_) {
             int x, y;
-            ConvertLaserScanToCartesian(x, y, range, base_scan_min_angle);
-            ConvertCartesianToScreen(x, y, screen_width, screen_height);
+            ConvertLaserScanToCartesian(x, y, range, base_scan_min_angle, view.scale_);
+            ConvertCartesianToScreen(x, y, view.screen_.width, view.screen_.height);
 
-            if (x >= 0 && y >= 0) {
-                //Swap places to adapt to OpenCV coordinate system
-                image.at<uchar>(y, x) = static_cast<uchar>(255);
+            if (x == last_x && y == last_y) {
+                //Neighbouring beams hitting the same pixel are plotted once,
+                //just like overwriting the pixel with 255 did before the blur
+                continue;
+            }
+
+            if (x >= 0 && y >= 0 && x < view.screen_.width && y < view.screen_.height) {
+                SplatPoint(image, x, y);
+                last_x = x;
+                last_y = y;
             } else {
                 //Coordinates are out of bound because of roundoff errors
                 ROS_INFO("Round off error: Coordinates out of bounds!");
             }
         }
     }
+}
+
+void CircleDetector::UpdateSplatKernel(const BandView& view) {
+    //The blur is given at the fine scale, so shrink it with the image
+    double ratio = view.scale_ / raster_params_.scale_factor_;
+    int size = std::max(3, static_cast<int>(blur_params_.kernel_size_ * ratio) | 1);
+    double sigma = std::max(0.5, blur_params_.sigma_ * ratio);
+
+    if (!splat_kernel_.empty() && splat_kernel_.rows == size && splat_sigma_ == sigma) {
+        return;
+    }
+    splat_sigma_ = sigma;
+
+    //The blur of a single 255 pixel is the outer product of the 1D kernels
+    cv::Mat kernel = cv::getGaussianKernel(size, sigma, CV_64F);
+    splat_kernel_.create(size, size, CV_8UC1);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            splat_kernel_.at<uchar>(y, x) = saturate_cast<uchar>(
+                255 * kernel.at<double>(y, 0) * kernel.at<double>(x, 0));
+        }
+    }
+}
 
-    return image;
+void CircleDetector::SplatPoint(cv::Mat& image, int x, int y) {
+    int half = splat_kernel_.rows / 2;
+
+    //Clip the footprint to the image
+    int first_x = std::max(x - half, 0), last_x = std::min(x + half, image.cols - 1);
+    int first_y = std::max(y - half, 0), last_y = std::min(y + half, image.rows - 1);
+
+    for (int row = first_y; row <= last_y; ++row) {
+        uchar* pixel = image.ptr<uchar>(row);
+        const uchar* weight = splat_kernel_.ptr<uchar>(row - y + half);
+        for (int col = first_x; col <= last_x; ++col) {
+            //Overlapping footprints add up like they do in the blur
+            pixel[col] = saturate_cast<uchar>(pixel[col] + weight[col - x + half]);
+        }
+    }
 }
 
-vector<Vec3f> CircleDetector::FindCircles(cv::Mat& image) {
-    //compute Hough Transform
-    cv::Mat destination;
-    cv::GaussianBlur(image, destination,
-                     Size(blur_params_.kernel_size_, blur_params_.kernel_size_),
-                     blur_params_.sigma_, blur_params_.sigma_);
+void CircleDetector::SplatPoints(cv::Mat& image, const std::vector<cv::Point2f>& points,
+                                 const BandView& view) {
+    int last_x = -1, last_y = -1;
+    for (size_t i = 0; i < points.size(); ++i) {
+        //same rounding as ConvertLaserScanToCartesian
+        int x = static_cast<int>(points[i].x * view.scale_);
+        int y = static_cast<int>(points[i].y * view.scale_);
+        ConvertCartesianToScreen(x, y, view.screen_.width, view.screen_.height);
 
+        if ((x == last_x && y == last_y) || x < 0 || y < 0
+                || x >= view.screen_.width || y >= view.screen_.height) {
+            continue;
+        }
+        SplatPoint(image, x, y);
+        last_x = x;
+        last_y = y;
+    }
+}
+
+void CircleDetector::UpdateLocalMap(const DetectionFrame& frame,
+                                    std::vector<cv::Point2f>& history) {
+    history.clear();
+    //without odometry the previous scans cannot be moved to the current pose
+    local_map_.SetCapacity(local_map_scans_ - 1);
+    if (local_map_scans_ <= 1 || !frame.have_odometry_) {
+        local_map_.Clear();
+        return;
+    }
+
+    std::vector<cv::Point2f> points;
+    local_map_.Collect(frame.pose_, history);
+    CreatePoints(frame.msg_, 0, BandMaxRange(raster_params_.bands_ - 1), points);
+    local_map_.Add(points, frame.pose_);
+}
+
+void CircleDetector::SelectHistory(const std::vector<cv::Point2f>& history,
+                                   const BandView& view,
+                                   std::vector<cv::Point2f>& selected) {
+    //only keep what the current scan would show in the searched part of the image
+    selected.clear();
+    float min_range_2 = view.min_range_ * view.min_range_;
+    float max_range_2 = view.max_range_ * view.max_range_;
+    const cv::Rect& window = view.window_;
+    for (size_t i = 0; i < history.size(); ++i) {
+        cv::Point2f point = history[i];
+        float range_2 = point.x * point.x + point.y * point.y;
+        float x = point.x * view.scale_ + view.screen_.width / 2;
+        float y = -point.y * view.scale_ + view.screen_.height / 2;
+        if (range_2 >= min_range_2 && range_2 < max_range_2
+                && x >= window.x && x < window.x + window.width
+                && y >= window.y && y < window.y + window.height) {
+            selected.push_back(point);
+        }
+    }
+}
+
+void CircleDetector::CreatePoints(const sensor_msgs::LaserScan::ConstPtr& msg,
+                                  double min_range, double max_range,
+                                  std::vector<cv::Point2f>& points) {
+    size_t data_points = msg->ranges.size();
+    points.clear();
+    points.reserve(data_points);
+
+    //same conversion as CreateImage but in metres and without rounding
+    float base_scan_min_angle = msg->angle_min;
+    for (int i = 0; i < data_points; ++i) {
+        float range = msg->ranges[data_points - 1 - i];
+        base_scan_min_angle += msg->angle_increment;
+        if (range >= min_range && range < max_range) {
+            points.push_back(cv::Point2f(range * sin(base_scan_min_angle),
+                                         range * cos(base_scan_min_angle)));
+        }
+    }
+}
+
+vector<Vec3f> CircleDetector::FindCircles(cv::Mat& image, const BandView& view,
+                                          const Deadline& deadline, bool& complete) {
+    //compute Hough Transform. The image is already blurred by CreateImage
     vector<Vec3f> circles;
-    cv::HoughCircles(destination, circles, CV_HOUGH_GRADIENT,
-                     hough_params_.dp_, hough_params_.min_dist_,
-                     hough_params_.threshold_1_, hough_params_.threshold_2_,
-                     hough_params_.min_radius_, hough_params_.max_radius_);
+    if (view.window_.area() == 0) {
+        return circles;
+    }
+    HoughParams params = ScaledHoughParams(view);
+    if (split_params_.radius_splits_ > 1 || split_params_.tiles_ > 1) {
+        //independent jobs on all cores, merged again afterwards
+        complete = SplitHoughCircles(image, view.window_, params, split_params_,
+                                     circles, deadline);
+        return circles;
+    }
+
+    cv::Mat window = image(view.window_);
+    cv::HoughCircles(window, circles, CV_HOUGH_GRADIENT,
+                     params.dp_, params.min_dist_,
+                     params.threshold_1_, params.threshold_2_,
+                     params.min_radius_, params.max_radius_);
+
+    //back to the coordinates of the whole image
+    for (size_t i = 0; i < circles.size(); ++i) {
+        circles[i][0] += view.window_.x;
+        circles[i][1] += view.window_.y;
+    }
 
     return circles;
 }
 
-//Define the LaserCallBack method which turns the maze into an image and then applies Hough Transform
-void CircleDetector::LaserCallback(const sensor_msgs::LaserScan::ConstPtr& msg) {
-    LoadParams();
-    cv::Mat image = CreateImage(msg);
+vector<Vec3f> CircleDetector::VoteCircles(std::vector<cv::Point2f>& points,
+                                          const BandView& view, const Deadline& deadline,
+                                          bool& complete) {
+    //the robot sits in the middle of the screen
+    cv::Point2f origin(view.screen_.width / 2, view.screen_.height / 2);
 
-    //compute Hough Transform
-    vector<Vec3f> circles = FindCircles(image);
+    std::vector<cv::Point2f> screen_points(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        screen_points[i] = cv::Point2f(points[i].x * view.scale_ + origin.x,
+                                       -points[i].y * view.scale_ + origin.y);
+    }
+
+    vector<Vec3f> circles;
+    complete = point_hough_.Detect(screen_points, origin, ScaledHoughParams(view), circles,
+                                   deadline);
 
-    // declare the x and y coordinates of the circle
-    double circle_x, circle_y;
-    TransformCircle(circle_x, circle_y, image, circles);
+    return circles;
+}
 
+vector<Vec3f> CircleDetector::MatchCircles(const sensor_msgs::LaserScan::ConstPtr& msg,
+                                           const BandView& view, const Deadline& deadline,
+                                           bool& complete) {
     std::vector<float> ranges(msg->ranges.begin(), msg->ranges.end());
-    PublishCircle(circle_x, circle_y, ranges);
+    double min_radius = hough_params_.min_radius_ / raster_params_.scale_factor_;
+    double max_radius = hough_params_.max_radius_ / raster_params_.scale_factor_;
+    if (view.radius_ > 0) {
+        min_radius = std::max(min_radius, view.radius_ * (1 - narrow_radius_share));
+        max_radius = std::min(max_radius, view.radius_ * (1 + narrow_radius_share));
+    }
+    std::vector<PolarMatch> matches;
+    complete = polar_matcher_.Match(ranges, msg->angle_increment, min_radius, max_radius,
+                                    view.max_range_, polar_max_error_, matches, deadline);
+
+    HoughParams params = ScaledHoughParams(view);
+    float min_dist_2 = static_cast<float>(params.min_dist_) * params.min_dist_;
+    size_t data_points = ranges.size();
+    vector<Vec3f> circles;
+    for (size_t i = 0; i < matches.size(); ++i) {
+        //closer circles belong to the previous band
+        if (matches[i].distance_ - matches[i].radius_ < view.min_range_) {
+            continue;
+        }
+
+        //same beam to angle mapping as CreatePoints, which walks the ranges backwards
+        float angle = msg->angle_min + (data_points - matches[i].index_) * msg->angle_increment;
+        float x = matches[i].distance_ * sin(angle) * view.scale_ + view.screen_.width / 2;
+        float y = -matches[i].distance_ * cos(angle) * view.scale_ + view.screen_.height / 2;
+
+        bool keep = true;
+        for (size_t j = 0; j < circles.size() && keep; ++j) {
+            float dx = x - circles[j][0], dy = y - circles[j][1];
+            keep = dx * dx + dy * dy >= min_dist_2;
+        }
+        if (keep) {
+            circles.push_back(Vec3f(x, y, matches[i].radius_ * view.scale_));
+        }
+    }
+
+    return circles;
+}
+
+sensor_msgs::LaserScan::ConstPtr CircleDetector::RestrictToTrack(
+    const sensor_msgs::LaserScan::ConstPtr& msg, const CircleTracker& tracker, BandView& view) {
+    view.window_ = cv::Rect(0, 0, view.screen_.width, view.screen_.height);
+    if (!track_params_.enabled_ || !tracker.Windowed()) {
+        return msg;
+    }
+
+    cv::Point2f centre = tracker.Position();
+    double reach = tracker.Radius() + track_params_.window_;
+    double distance = sqrt(centre.x * centre.x + centre.y * centre.y);
+    if (distance <= reach) {
+        //the robot is inside the window, nothing to restrict
+        return msg;
+    }
+
+    //part of the image around the prediction, grown by the splat footprint
+    double ratio = view.scale_ / raster_params_.scale_factor_;
+    int half = static_cast<int>(std::ceil(reach * view.scale_ + blur_params_.kernel_size_ * ratio));
+    int x = cvRound(centre.x * view.scale_ + view.screen_.width / 2);
+    int y = cvRound(-centre.y * view.scale_ + view.screen_.height / 2);
+    view.window_ &= cv::Rect(x - half, y - half, 2 * half + 1, 2 * half + 1);
+
+    //beams that can hit the window, with the same beam to angle mapping as CreatePoints
+    size_t data_points = msg->ranges.size();
+    double centre_index = data_points - (atan2(centre.x, centre.y) - msg->angle_min)
+                          / msg->angle_increment;
+    double half_width = asin(reach / distance) / msg->angle_increment + 1;
+
+    sensor_msgs::LaserScan::Ptr scan(new sensor_msgs::LaserScan(*msg));
+    for (size_t i = 0; i < data_points; ++i) {
+        float range = scan->ranges[i];
+        if (fabs(i - centre_index) > half_width || range < distance - reach
+                || range > distance + reach) {
+            scan->ranges[i] = std::numeric_limits<float>::infinity();
+        }
+    }
+    return scan;
+}
+
+void CircleDetector::OdomCallback(const nav_msgs::Odometry::ConstPtr& msg) {
+    const geometry_msgs::Quaternion& orientation = msg->pose.pose.orientation;
+    odom_pose_.x_ = msg->pose.pose.position.x;
+    odom_pose_.y_ = msg->pose.pose.position.y;
+    odom_pose_.theta_ = YawFromQuaternion(orientation.x, orientation.y,
+                                          orientation.z, orientation.w);
+    odom_linear_velocity_ = msg->twist.twist.linear.x;
+    odom_angular_velocity_ = msg->twist.twist.angular.z;
+    have_odometry_ = true;
+}
+
+void CircleDetector::DemandCallback(const std_msgs::Bool::ConstPtr& msg) {
+    if (msg->data != demanded_) {
+        ROS_INFO("Circle detections %s", msg->data ? "needed" : "not needed");
+    }
+    demanded_ = msg->data;
+}
+
+//Define the LaserCallBack method which turns the maze into an image and then applies Hough Transform
+void CircleDetector::LaserCallback(const sensor_msgs::LaserScan::ConstPtr& raw_msg) {
+    if (IdleScan() || ThrottleScan(raw_msg)) {
+        return;
+    }
+    sensor_msgs::LaserScan::ConstPtr msg = DeskewScan(raw_msg);
+
+    if (pipelined_) {
+        //the rasterisation thread takes the newest scan once it has a free
+        //frame, scans it had no time for are overwritten
+        std::lock_guard<std::mutex> guard(scan_mutex_);
+        latest_scan_ = msg;
+        latest_pose_ = odom_pose_;
+        latest_have_odometry_ = have_odometry_;
+        return;
+    }
+
+    //the parameters are read once at start-up in both modes, reading them
+    //again would block on the parameter server for every scan
+    if (SkipScan()) {
+        return;
+    }
+    DetectionFrame& frame = frames_[0];
+    frame.msg_ = msg;
+    frame.pose_ = odom_pose_;
+    frame.have_odometry_ = have_odometry_;
+    int64 start = cv::getTickCount();
+    PrepareFrame(frame);
+    frame.prepare_time_ = Seconds(start);
+    DetectFrame(frame);
+}
+
+bool CircleDetector::IdleScan() {
+    if (demanded_ && circle_detect_pub_.getNumSubscribers() > 0) {
+        idle_count_ = 0;
+        return false;
+    }
+    if (idle_scan_stride_ <= 0) {
+        return true;
+    }
+    return idle_count_++ % idle_scan_stride_ != 0;
+}
+
+sensor_msgs::LaserScan::ConstPtr CircleDetector::DeskewScan(
+        const sensor_msgs::LaserScan::ConstPtr& msg) {
+    if (!deskew_scans_ || !have_odometry_) {
+        return msg;
+    }
+    sensor_msgs::LaserScan::Ptr corrected(new sensor_msgs::LaserScan(*msg));
+    if (!deskewer_.Deskew(*msg, odom_linear_velocity_, odom_angular_velocity_,
+                          corrected->ranges)) {
+        return msg;
+    }
+    corrected->header.stamp = msg->header.stamp + ros::Duration(msg->scan_time);
+    return corrected;
+}
+
+bool CircleDetector::ThrottleScan(const sensor_msgs::LaserScan::ConstPtr& msg) {
+    if (detection_rate_ <= 0) {
+        return false;
+    }
+    //half a scan of slack, so jitter in the stamps does not drop a scan
+    //that is due
+    double slack = std::max(msg->scan_time / 2.0, min_rate_slack);
+    double elapsed = (msg->header.stamp - last_detected_stamp_).toSec();
+    if (!last_detected_stamp_.isZero() && elapsed >= 0
+            && elapsed + slack < 1.0 / detection_rate_) {
+        return true;
+    }
+    last_detected_stamp_ = msg->header.stamp;
+    return false;
+}
+
+bool CircleDetector::SkipScan() {
+    if (load_level_ < LOAD_SKIP_FRAMES) {
+        skip_count_ = 0;
+        return false;
+    }
+    return skip_count_++ % 2 == 1;
 }
 
-void CircleDetector::TransformCircle(double& circle_x, double& circle_y,
-                                     cv::Mat& image, std::vector<Vec3f>& circles) {
-    //If the circle is found then the coordinates are converted to screen coordinates
-    if (circles.size() == 1) {
-        circle_x = (circles[0][0] - image.rows / 2) / 100;
-        circle_y = -((circles[0][1] - image.cols / 2) / 100);
+void CircleDetector::RasterLoop() {
+    DetectionFrame* frame = nullptr;
+    while (running_) {
+        //wait for a frame the detection stage is done with
+        if (frame == nullptr && !free_frames_.TryPop(frame)) {
+            ros::WallDuration(pipeline_idle).sleep();
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(scan_mutex_);
+            frame->msg_ = latest_scan_;
+            frame->pose_ = latest_pose_;
+            frame->have_odometry_ = latest_have_odometry_;
+            latest_scan_ = sensor_msgs::LaserScan::ConstPtr();
+        }
+        if (!frame->msg_) {
+            ros::WallDuration(pipeline_idle).sleep();
+            continue;
+        }
+        if (SkipScan()) {
+            frame->msg_ = sensor_msgs::LaserScan::ConstPtr();
+            continue;
+        }
+
+        int64 start = cv::getTickCount();
+        PrepareFrame(*frame);
+        frame->prepare_time_ = Seconds(start);
+        //the queue has a slot for every frame, so this cannot fail
+        ready_frames_.TryPush(frame);
+        frame = nullptr;
     }
-    //If the circle is not found, then the x and y coordinates are set to -10 because this
-    //is a value that will never be achieved
-    else {
-        circle_x = -10;
-        circle_y = -10;
+}
+
+void CircleDetector::DetectLoop() {
+    while (running_) {
+        DetectionFrame* frame;
+        if (!ready_frames_.TryPop(frame)) {
+            ros::WallDuration(pipeline_idle).sleep();
+            continue;
+        }
+
+        //the latest frame wins, older ones go back undetected
+        DetectionFrame* newer;
+        while (ready_frames_.TryPop(newer)) {
+            free_frames_.TryPush(frame);
+            frame = newer;
+        }
+
+        DetectFrame(*frame);
+        free_frames_.TryPush(frame);
+    }
+}
+
+double CircleDetector::PredictTrack(const TrackState& state, const DetectionFrame& frame,
+                                    CircleTracker& tracker) {
+    double dt = state.stamp_.isZero() ? 0 : (frame.msg_->header.stamp - state.stamp_).toSec();
+    dt = std::max(0.0, dt);
+    Pose2D motion = MakePose(0, 0, 0);
+    if (state.have_odometry_ && frame.have_odometry_) {
+        motion = LaserMotion(RelativePose(state.pose_, frame.pose_), laser_offset_);
+    }
+
+    tracker.SetParams(track_params_);
+    if (track_params_.enabled_) {
+        tracker.Predict(dt, motion);
+    } else {
+        tracker.Reset();
+    }
+    return dt;
+}
+
+void CircleDetector::PrepareFrame(DetectionFrame& frame) {
+    frame.active_bands_ = 0;
+    frame.load_level_ = load_level_;
+
+    //move the circle hypothesis to this scan. In pipelined mode the previous
+    //scan may still be in detection, then the one before is moved instead
+    TrackState state;
+    {
+        std::lock_guard<std::mutex> guard(track_mutex_);
+        state = track_state_;
+    }
+    CircleTracker tracker = state.tracker_;
+    PredictTrack(state, frame, tracker);
+
+    //points of the previous scans, moved to where the robot is now
+    std::vector<cv::Point2f> history;
+    UpdateLocalMap(frame, history);
+
+    //Most scans only show walls and corners, so skip the detector unless
+    //something in the scan or in the previous scans searched with it curves
+    //like a circle. A locked track already has a circle in the scan
+    const sensor_msgs::LaserScan::ConstPtr& msg = frame.msg_;
+    bool locked = track_params_.enabled_ && tracker.Locked();
+    if (!locked && arc_params_.enabled_) {
+        std::vector<float> ranges(msg->ranges.begin(), msg->ranges.end());
+        bool has_arc = HasArcCandidate(ranges, msg->angle_min, msg->angle_increment, arc_params_);
+        if (!arc_gate_.Pass(has_arc, history.empty() ? 1 : local_map_scans_)) {
+            return;
+        }
+    }
+
+    //a locked track only needs the band of the predicted circle, except in
+    //the full searches for other circles
+    int first_band = 0, last_band = raster_params_.bands_ - 1;
+    if (track_params_.enabled_ && tracker.Windowed()) {
+        cv::Point2f centre = tracker.Position();
+        first_band = last_band = BandOf(sqrt(centre.x * centre.x + centre.y * centre.y));
+    }
+    if (frame.bands_.size() < static_cast<size_t>(raster_params_.bands_)) {
+        frame.bands_.resize(raster_params_.bands_);
+    }
+    //Under overload the governor trades quality for time, every level on top
+    //of the ones before
+    for (int band = first_band; band <= last_band; ++band) {
+        BandRaster& raster = frame.bands_[frame.active_bands_++];
+        SelectResolution(band, state.circle_distance_,
+                         frame.load_level_ >= LOAD_COARSE_RASTER, raster.view_);
+        if (frame.load_level_ >= LOAD_NARROW_RADIUS && tracker.Active()) {
+            raster.view_.radius_ = tracker.Radius();
+        }
+        if (frame.load_level_ >= LOAD_CHEAP_BACKEND) {
+            raster.view_.backend_ = POLAR_TEMPLATE;
+        }
+        PrepareBand(msg, history, tracker, raster);
+    }
+}
+
+void CircleDetector::DetectFrame(DetectionFrame& frame) {
+    int64 start = cv::getTickCount();
+
+    //only this stage writes track_state_, so it can read it without the lock
+    CircleTracker tracker = track_state_.tracker_;
+    double dt = PredictTrack(track_state_, frame, tracker);
+
+    //Anytime detection: once the budget is used up the bands still to come
+    //are skipped and the circles found so far are published as incomplete
+    Deadline deadline(detection_budget_);
+    std::vector<CircleFit> candidates;
+    bool complete = true;
+    for (size_t i = 0; i < frame.active_bands_; ++i) {
+        if (!complete || deadline.Expired()) {
+            complete = false;
+            break;
+        }
+        complete = DetectInBand(frame.bands_[i], deadline, candidates);
+    }
+
+    // -10 is a value that will never be achieved and marks that there is no
+    // circle, a residual of -1 marks that no fit was made
+    CircleFit circle;
+    circle.centre_ = cv::Point2f(-10, -10);
+    circle.radius_ = 0;
+    circle.residual_ = -1;
+    int track_age = 0;
+    double track_confidence = 0;
+    int used = -1;
+    if (track_params_.enabled_) {
+        used = tracker.Update(candidates, dt);
+        if (tracker.Active()) {
+            circle.centre_ = tracker.Position();
+            circle.radius_ = tracker.Radius();
+            circle.residual_ = used < 0 ? -1 : candidates[used].residual_;
+            track_age = tracker.Age();
+            track_confidence = tracker.Confidence();
+        }
+    } else if (!candidates.empty()) {
+        circle = candidates[MostConfident(candidates)];
+        track_confidence = 1;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(track_mutex_);
+        track_state_.tracker_ = tracker;
+        track_state_.stamp_ = frame.msg_->header.stamp;
+        track_state_.pose_ = frame.pose_;
+        track_state_.have_odometry_ = frame.have_odometry_;
+        track_state_.circle_distance_ = -1;
+        if (circle.radius_ > 0) {
+            track_state_.circle_distance_ = sqrt(circle.centre_.x * circle.centre_.x
+                                                 + circle.centre_.y * circle.centre_.y);
+        }
+    }
+
+    //Every circle of the scan is published as well, most confident first, so
+    //a corner next to the goal does not hide the goal from the controller.
+    //The circle the track follows is trusted at least as much as the track
+    std::vector<robot::circle_candidate> published;
+    float tolerance = 1.0 / raster_params_.scale_factor_;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        robot::circle_candidate candidate;
+        candidate.x = candidates[i].centre_.x;
+        candidate.y = candidates[i].centre_.y;
+        candidate.radius = candidates[i].radius_;
+        candidate.fit_residual = candidates[i].residual_;
+        candidate.confidence = FitConfidence(candidates[i], tolerance);
+        if (static_cast<int>(i) == used) {
+            candidate.confidence = std::max(candidate.confidence, track_confidence);
+        }
+        published.push_back(candidate);
+    }
+    std::stable_sort(published.begin(), published.end(), CompareConfidence);
+
+    std::vector<float> ranges(frame.msg_->ranges.begin(), frame.msg_->ranges.end());
+    PublishCircle(circle.centre_.x, circle.centre_.y, circle.radius_, circle.residual_,
+                  track_age, track_confidence, published, complete, frame.load_level_,
+                  frame.msg_->header.stamp, ranges);
+    GovernLoad(frame, dt, Seconds(start));
+}
+
+void CircleDetector::GovernLoad(const DetectionFrame& frame, double dt, double detect_time) {
+    //The pipelined stages overlap, so the slower one sets the pace
+    double processing_time = frame.prepare_time_ + detect_time;
+    if (pipelined_) {
+        processing_time = std::max(frame.prepare_time_, detect_time);
+    }
+
+    //A skipped scan leaves its time to the next one, and so does a lower
+    //detection rate. Without a scan time the time since the previous
+    //detected scan is what there was
+    double available_time = dt;
+    if (frame.msg_->scan_time > 0) {
+        int stride = frame.load_level_ >= LOAD_SKIP_FRAMES ? 2 : 1;
+        available_time = frame.msg_->scan_time * stride;
+        if (detection_rate_ > 0) {
+            available_time = std::max(available_time, 1.0 / detection_rate_);
+        }
+    }
+
+    governor_.SetParams(governor_params_);
+    int level = governor_.Update(processing_time, available_time);
+    if (level != load_level_) {
+        ROS_INFO("Detector load %.2f, switching to level %d", governor_.Load(), level);
+    }
+    load_level_ = level;
+}
+
+void CircleDetector::PrepareBand(const sensor_msgs::LaserScan::ConstPtr& msg,
+                                 const std::vector<cv::Point2f>& history,
+                                 const CircleTracker& tracker, BandRaster& raster) {
+    raster.scan_ = RestrictToTrack(msg, tracker, raster.view_);
+
+    std::vector<cv::Point2f> band_history;
+    CreatePoints(raster.scan_, raster.view_.min_range_, raster.view_.max_range_, raster.points_);
+    SelectHistory(history, raster.view_, band_history);
+    raster.points_.insert(raster.points_.end(), band_history.begin(), band_history.end());
+
+    //only the gradient backend needs an image
+    if (raster.view_.backend_ == HOUGH_GRADIENT) {
+        CreateImage(raster.scan_, raster.view_, raster.image_);
+        SplatPoints(raster.image_, band_history, raster.view_);
+    }
+}
+
+bool CircleDetector::DetectInBand(BandRaster& raster, const Deadline& deadline,
+                                  std::vector<CircleFit>& candidates) {
+    vector<Vec3f> circles;
+    bool complete = true;
+    if (raster.view_.backend_ == POINT_VOTE) {
+        //vote directly from the scan points, no image needed
+        circles = VoteCircles(raster.points_, raster.view_, deadline, complete);
+    } else if (raster.view_.backend_ == POLAR_TEMPLATE) {
+        //match the dip a circle leaves in the ranges, no image needed.
+        //The previous scans only help the refinement here
+        circles = MatchCircles(raster.scan_, raster.view_, deadline, complete);
+    } else {
+        //compute Hough Transform
+        circles = FindCircles(raster.image_, raster.view_, deadline, complete);
+    }
+
+    //circles in the overlap of two bands are found in both
+    std::vector<CircleFit> band_candidates;
+    TransformCircles(circles, raster.points_, raster.view_, band_candidates);
+    for (size_t i = 0; i < band_candidates.size(); ++i) {
+        bool duplicate = false;
+        for (size_t j = 0; j < candidates.size() && !duplicate; ++j) {
+            cv::Point2f offset = band_candidates[i].centre_ - candidates[j].centre_;
+            duplicate = sqrt(offset.x * offset.x + offset.y * offset.y) < candidates[j].radius_;
+        }
+        if (!duplicate) {
+            candidates.push_back(band_candidates[i]);
+        }
+    }
+    return complete;
+}
+
+void CircleDetector::TransformCircles(std::vector<Vec3f>& circles,
+                                      std::vector<cv::Point2f>& points,
+                                      const BandView& view,
+                                      std::vector<CircleFit>& candidates) {
+    //The circles are converted from screen coordinates to metres
+    candidates.clear();
+    for (size_t i = 0; i < circles.size(); ++i) {
+        CircleFit circle;
+        circle.centre_ = cv::Point2f((circles[i][0] - view.screen_.width / 2) / view.scale_,
+                                     -((circles[i][1] - view.screen_.height / 2) / view.scale_));
+        circle.radius_ = circles[i][2] / view.scale_;
+        circle.residual_ = -1;
+        RefineCircle(circle, points, view);
+        candidates.push_back(circle);
+    }
+}
+
+void CircleDetector::RefineCircle(CircleFit& circle, std::vector<cv::Point2f>& points,
+                                  const BandView& view) {
+    //Points within two pixels of the Hough circle belong to it
+    float pixel = 1.0 / view.scale_;
+    std::vector<cv::Point2f> selected;
+    SelectCirclePoints(points, circle.centre_, circle.radius_, 2 * pixel, selected);
+
+    //The algebraic fit is a closer starting point than the Hough circle
+    CircleFit fit = circle;
+    cv::Point2f centre;
+    float radius;
+    if (FitCircleAlgebraic(selected, centre, radius)) {
+        fit.centre_ = centre;
+        fit.radius_ = radius;
+    }
+
+    if (!FitCircleGeometric(selected, fit, fit_iterations_)) {
+        return;
+    }
+
+    //The fit only refines the Hough circle, it may not move it to another place
+    if (std::hypot(fit.centre_.x - circle.centre_.x, fit.centre_.y - circle.centre_.y) <= 2 * pixel) {
+        circle = fit;
     }
 }
 
-void CircleDetector::PublishCircle(double circle_x, double circle_y, std::vector<float>& ranges) {
-    //Setting the values that will be published
+void CircleDetector::PublishCircle(double circle_x, double circle_y, double radius,
+                                   double residual, int track_age, double track_confidence,
+                                   std::vector<robot::circle_candidate>& candidates,
+                                   bool complete, int load_level, const ros::Time& stamp,
+                                   std::vector<float>& ranges) {
+    //Setting the values that will be published. The stamp is that of the
+    //scan, so the controller can move the circles by the odometry since then
     robot::circle_detect_msg pub_msg;
-    pub_msg.header.stamp = ros::Time::now();
+    pub_msg.header.stamp = stamp.isZero() ? ros::Time::now() : stamp;
     pub_msg.header.frame_id = "/robot";
     pub_msg.circle_x = circle_x;
     pub_msg.circle_y = circle_y;
+    pub_msg.circle_radius = radius;
+    pub_msg.fit_residual = residual;
+    pub_msg.track_age = track_age;
+    pub_msg.track_confidence = track_confidence;
+    pub_msg.candidates = candidates;
+    pub_msg.detection_complete = complete;
+    pub_msg.load_level = load_level;
     pub_msg.ranges = ranges;
     circle_detect_pub_.publish(pub_msg);
 }
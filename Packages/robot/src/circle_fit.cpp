@@ -0,0 +1,168 @@
+/**
+ * @file circle_fit.cpp
+ * @brief Defines the least-squares circle fitting functions
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "circle_fit.h"
+
+#include <cmath>
+#include <opencv2/core/core.hpp>
+#include <vector>
+
+void SelectCirclePoints(const std::vector<cv::Point2f>& points, const cv::Point2f& centre,
+                        float radius, float tolerance, std::vector<cv::Point2f>& selected) {
+    selected.clear();
+    for (size_t i = 0; i < points.size(); ++i) {
+        float dx = points[i].x - centre.x, dy = points[i].y - centre.y;
+        if (std::fabs(std::sqrt(dx * dx + dy * dy) - radius) <= tolerance) {
+            selected.push_back(points[i]);
+        }
+    }
+}
+
+bool FitCircleAlgebraic(const std::vector<cv::Point2f>& points, cv::Point2f& centre,
+                        float& radius) {
+    size_t size = points.size();
+    if (size < 3) {
+        return false;
+    }
+
+    // Work relative to the mean to keep the normal equations well conditioned
+    double mean_x = 0, mean_y = 0;
+    for (size_t i = 0; i < size; ++i) {
+        mean_x += points[i].x;
+        mean_y += points[i].y;
+    }
+    mean_x /= size;
+    mean_y /= size;
+
+    // Moments of the centred points
+    double suu = 0, svv = 0, suv = 0, suuu = 0, svvv = 0, suvv = 0, svuu = 0;
+    for (size_t i = 0; i < size; ++i) {
+        double u = points[i].x - mean_x, v = points[i].y - mean_y;
+        suu += u * u;
+        svv += v * v;
+        suv += u * v;
+        suuu += u * u * u;
+        svvv += v * v * v;
+        suvv += u * v * v;
+        svuu += v * u * u;
+    }
+
+    // Solve [suu suv; suv svv] [uc; vc] = 0.5 [suuu + suvv; svvv + svuu]
+    double determinant = suu * svv - suv * suv;
+    if (std::fabs(determinant) < 1e-12 * (suu + svv) * (suu + svv)) {
+        return false;
+    }
+    double right_u = 0.5 * (suuu + suvv), right_v = 0.5 * (svvv + svuu);
+    double centre_u = (right_u * svv - right_v * suv) / determinant;
+    double centre_v = (right_v * suu - right_u * suv) / determinant;
+
+    centre.x = static_cast<float>(centre_u + mean_x);
+    centre.y = static_cast<float>(centre_v + mean_y);
+    radius = static_cast<float>(std::sqrt(centre_u * centre_u + centre_v * centre_v
+                                          + (suu + svv) / size));
+    return true;
+}
+
+bool FitCircleGeometric(const std::vector<cv::Point2f>& points, CircleFit& fit,
+                        int iterations) {
+    size_t size = points.size();
+    if (size < 3) {
+        return false;
+    }
+
+    double a = fit.centre_.x, b = fit.centre_.y, r = fit.radius_;
+    double squared_error = 0;
+    for (int iteration = 0; iteration <= iterations; ++iteration) {
+        // Normal equations J^T J delta = -J^T e of the residuals
+        // e_i = |p_i - c| - r, with J_i = [-(x_i - a) / d_i, -(y_i - b) / d_i, -1]
+        double jtj[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+        double jte[3] = {0, 0, 0};
+        squared_error = 0;
+        for (size_t i = 0; i < size; ++i) {
+            double dx = points[i].x - a, dy = points[i].y - b;
+            double distance = std::sqrt(dx * dx + dy * dy);
+            if (distance < 1e-9) {
+                return false;
+            }
+            double error = distance - r;
+            double jacobian[3] = {-dx / distance, -dy / distance, -1};
+            squared_error += error * error;
+            for (int row = 0; row < 3; ++row) {
+                jte[row] += jacobian[row] * error;
+                for (int col = 0; col < 3; ++col) {
+                    jtj[row][col] += jacobian[row] * jacobian[col];
+                }
+            }
+        }
+
+        // The last pass only evaluates the residual of the final estimate
+        if (iteration == iterations) {
+            break;
+        }
+
+        // Solve the 3x3 system with Cramer's rule
+        double determinant = jtj[0][0] * (jtj[1][1] * jtj[2][2] - jtj[1][2] * jtj[2][1])
+                             - jtj[0][1] * (jtj[1][0] * jtj[2][2] - jtj[1][2] * jtj[2][0])
+                             + jtj[0][2] * (jtj[1][0] * jtj[2][1] - jtj[1][1] * jtj[2][0]);
+        if (std::fabs(determinant) < 1e-15) {
+            return false;
+        }
+        double delta[3];
+        for (int k = 0; k < 3; ++k) {
+            double m[3][3];
+            for (int row = 0; row < 3; ++row) {
+                for (int col = 0; col < 3; ++col) {
+                    m[row][col] = col == k ? -jte[row] : jtj[row][col];
+                }
+            }
+            delta[k] = (m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+                        - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+                        + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0])) / determinant;
+        }
+
+        a += delta[0];
+        b += delta[1];
+        r += delta[2];
+        if (!(r > 0)) {
+            return false;
+        }
+
+        // Converged well below anything the laser can resolve
+        if (std::fabs(delta[0]) + std::fabs(delta[1]) + std::fabs(delta[2]) < 1e-7) {
+            iterations = iteration + 1;
+        }
+    }
+
+    fit.centre_ = cv::Point2f(static_cast<float>(a), static_cast<float>(b));
+    fit.radius_ = static_cast<float>(r);
+    fit.residual_ = static_cast<float>(std::sqrt(squared_error / size));
+    return true;
+}
+
+float FitConfidence(const CircleFit& fit, float tolerance) {
+    // Too few points close to the circle to fit it at all
+    if (fit.residual_ < 0) {
+        return 0.25;
+    }
+    return tolerance / (tolerance + fit.residual_);
+}
+
+int MostConfident(const std::vector<CircleFit>& circles) {
+    int best = -1;
+    for (size_t i = 0; i < circles.size(); ++i) {
+        float residual = circles[i].residual_;
+        if (best < 0 || (residual >= 0 && (circles[best].residual_ < 0
+                                           || residual < circles[best].residual_))) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
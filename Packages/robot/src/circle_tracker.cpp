@@ -0,0 +1,147 @@
+/**
+ * @file circle_tracker.cpp
+ * @brief This file contains the implementation of the tracker that follows
+ * the circle between scans.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "circle_tracker.h"
+#include "pose_helpers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+CircleTracker::CircleTracker() : active_(false), radius_(0), age_(0), hits_(0), misses_(0) {
+    params_.enabled_ = false;
+    params_.alpha_ = 1;
+    params_.beta_ = 0;
+    params_.gate_ = 0;
+    params_.window_ = 0;
+    params_.lock_hits_ = 1;
+    params_.max_misses_ = 0;
+    params_.full_search_frames_ = 0;
+}
+
+void CircleTracker::SetParams(const TrackParams& params) {
+    params_ = params;
+}
+
+void CircleTracker::Reset() {
+    active_ = false;
+    position_ = cv::Point2f(0, 0);
+    velocity_ = cv::Point2f(0, 0);
+    radius_ = 0;
+    age_ = 0;
+    hits_ = 0;
+    misses_ = 0;
+}
+
+void CircleTracker::Predict(double dt, const Pose2D& motion) {
+    if (!active_) {
+        return;
+    }
+
+    //The detector frame has x to the right and y forward, so it is the ROS
+    //frame turned by 90 degrees
+    double x = position_.y, y = -position_.x;
+    TransformToMovedFrame(motion, x, y);
+    Pose2D rotation = motion;
+    rotation.x_ = 0;
+    rotation.y_ = 0;
+    double velocity_x = velocity_.y, velocity_y = -velocity_.x;
+    TransformToMovedFrame(rotation, velocity_x, velocity_y);
+
+    velocity_ = cv::Point2f(-velocity_y, velocity_x);
+    position_ = cv::Point2f(-y + velocity_.x * dt, x + velocity_.y * dt);
+}
+
+int CircleTracker::Update(const std::vector<CircleFit>& candidates, double dt) {
+    if (!active_) {
+        //A wrong start is dropped again after a few misses, while waiting
+        //for a scan with a single circle could take forever
+        int best = MostConfident(candidates);
+        if (best < 0) {
+            return -1;
+        }
+        Reset();
+        active_ = true;
+        position_ = candidates[best].centre_;
+        radius_ = candidates[best].radius_;
+        age_ = 1;
+        hits_ = 1;
+        return best;
+    }
+
+    ++age_;
+
+    //Associate the detection closest to the prediction
+    int best = -1;
+    float best_distance = static_cast<float>(params_.gate_);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        cv::Point2f error = candidates[i].centre_ - position_;
+        float distance = std::sqrt(error.x * error.x + error.y * error.y);
+        if (distance <= best_distance) {
+            best_distance = distance;
+            best = static_cast<int>(i);
+        }
+    }
+
+    if (best < 0) {
+        if (++misses_ > params_.max_misses_) {
+            Reset();
+        }
+        return -1;
+    }
+
+    cv::Point2f error = candidates[best].centre_ - position_;
+    position_ += error * static_cast<float>(params_.alpha_);
+    if (dt > 0) {
+        velocity_ += error * static_cast<float>(params_.beta_ / dt);
+    }
+    radius_ += static_cast<float>(params_.alpha_) * (candidates[best].radius_ - radius_);
+    ++hits_;
+    misses_ = 0;
+    return best;
+}
+
+bool CircleTracker::Active() const {
+    return active_;
+}
+
+bool CircleTracker::Locked() const {
+    return active_ && hits_ >= params_.lock_hits_;
+}
+
+bool CircleTracker::Windowed() const {
+    //Age counts the scans of the track, the next one is searched in full
+    //every full_search_frames_ scans
+    bool full_search = params_.full_search_frames_ > 0
+                       && (age_ + 1) % params_.full_search_frames_ == 0;
+    return Locked() && !full_search;
+}
+
+cv::Point2f CircleTracker::Position() const {
+    return position_;
+}
+
+float CircleTracker::Radius() const {
+    return radius_;
+}
+
+int CircleTracker::Age() const {
+    return age_;
+}
+
+double CircleTracker::Confidence() const {
+    if (!active_) {
+        return 0;
+    }
+    double lock = std::min(1.0, static_cast<double>(hits_) / std::max(1, params_.lock_hits_));
+    return lock * (1 - static_cast<double>(misses_) / (params_.max_misses_ + 1));
+}
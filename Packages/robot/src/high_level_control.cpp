@@ -12,13 +12,98 @@
 #include <ros/ros.h>
 #include <sensor_msgs/LaserScan.h>
 #include <geometry_msgs/Twist.h>
+#include <std_msgs/Bool.h>
+#include <algorithm>
 #include <cmath>
 #include "robot/circle_detect_msg.h"
 #include "high_level_control.h"
 #include "util_functions.h"
 #include "logger.h"
 
-HighLevelControl::HighLevelControl() : node_() {
+namespace {
+
+// Distance in metres the chosen circle may move between two detections and
+// still be taken for the same circle
+const double follow_gate = 0.3;
+
+// Detections in a row that may miss the chosen circle before it is lost
+const int max_follow_misses = 5;
+
+// Seconds of odometry kept to move detections made on older scans
+const double pose_history_span = 2.0;
+
+// Share of the approach velocity the robot keeps until it touches the circle
+const double min_approach_share = 0.2;
+
+// The path to a circle ends this much before the circle is seen, so the
+// points of the circle itself do not block it
+const double corridor_margin = 0.02;
+
+// A corner can look like a circle, but its walls go on beside it. Past a real
+// circle the beam this many degrees to the open side reaches at least this
+// many metres behind its centre
+const double corner_check_angle = 20;
+const double corner_clearance = 1;
+
+// Directions to the right and left of the heading in which the map is asked
+// for unknown space when a wall side is picked, and how far
+const double explore_angle = M_PI / 3;
+const double explore_distance = 3;
+
+// Scans after which the frontier is picked again from the grown map
+const int frontier_replan_scans = 10;
+
+// A frontier this close in metres has been reached
+const double frontier_reached_distance = 0.3;
+
+// Scans in a row the way to a frontier may be blocked before it is given up
+const int max_blocked_scans = 30;
+
+// Frontiers this close in metres to one given up are not picked
+const double unreachable_radius = 0.5;
+
+// Scans after which the path to the goal is planned again from the grown map
+const int plan_replan_scans = 5;
+
+// The goal is reached this close in metres
+const double goal_reached_distance = 0.5;
+
+// The robot drives towards the first waypoint at least this far in metres
+const double plan_lookahead = 0.4;
+
+// A goal in the map frame is moved into the odometry frame again once the
+// localisation has moved it this far in metres
+const double goal_shift_tolerance = 0.1;
+
+// The robot counts as localised while the positions the localisation still
+// considers spread less than this in metres
+const double localised_spread = 0.1;
+
+// Moves a point in circle coordinates by the motion of the robot. The circle
+// coordinates are seen from the LRF and have x to the right and y forward,
+// the odometry has x forward and y to the left
+void MoveCirclePoint(const Pose2D& motion, double laser_offset,
+                     double& circle_x, double& circle_y) {
+    double x = circle_y, y = -circle_x;
+    TransformToMovedFrame(LaserMotion(motion, laser_offset), x, y);
+    circle_x = -y;
+    circle_y = x;
+}
+
+}
+
+HighLevelControl::HighLevelControl() : node_(), detections_needed_(false),
+    circle_x_(-10), circle_y_(-10), follow_misses_(0), have_odometry_(false),
+    pose_history_(pose_history_span), odom_linear_velocity_(0),
+    odom_angular_velocity_(0), commanded_linear_velocity_(0),
+    commanded_angular_velocity_(0), deskew_scans_(false), laser_offset_(0),
+    map_enabled_(false),
+    explore_mode_(false), frontier_min_size_(0), frontier_gain_weight_(0),
+    has_frontier_(false), explore_scans_(0), blocked_scans_(0), plan_to_goal_(false),
+    goal_x_(0), goal_y_(0), goal_in_map_(false), odom_goal_x_(0), odom_goal_y_(0),
+    has_odom_goal_(false), plan_scans_(0), plan_finished_(false), localised_(false) {
+    odom_pose_ = MakePose(0, 0, 0);
+    circle_pose_ = map_fix_ = map_fix_odom_ = odom_pose_;
     InitialiseMoveSpecs();
     InitialiseMoveStatus();
     InitialiseTopicConnections();
@@ -26,7 +111,8 @@ HighLevelControl::HighLevelControl() : node_() {
 
 void HighLevelControl::InitialiseTopicConnections() {
     bool loaded = true;
-    std::string publish_topic, laser_topic, circle_topic;
+    std::string publish_topic, laser_topic, circle_topic, demand_topic, odom_topic,
+                map_pose_topic;
 
     if (!node_.getParam("publish_topic",
                         publish_topic)) {
@@ -43,6 +129,21 @@ void HighLevelControl::InitialiseTopicConnections() {
         loaded = false;
     }
 
+    if (!node_.getParam("demand_topic",
+                        demand_topic)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("odom_topic",
+                        odom_topic)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("map_pose_topic",
+                        map_pose_topic)) {
+        loaded = false;
+    }
+
     if (loaded == false) {
         ROS_INFO("Topics failed to load!");
         ros::shutdown();
@@ -51,6 +152,19 @@ void HighLevelControl::InitialiseTopicConnections() {
     cmd_vel_pub_ = node_.advertise<geometry_msgs::Twist>(publish_topic, 100);
     laser_sub_ = node_.subscribe(laser_topic, 100, &HighLevelControl::LaserCallback, this);
     circle_sub_ = node_.subscribe(circle_topic, 100, &HighLevelControl::CircleCallback, this);
+    if (!odom_topic.empty()) {
+        odom_sub_ = node_.subscribe(odom_topic, 100, &HighLevelControl::OdomCallback, this);
+    }
+    if (!map_pose_topic.empty()) {
+        map_pose_sub_ = node_.subscribe(map_pose_topic, 100, &HighLevelControl::MapPoseCallback,
+                                        this);
+    }
+
+    // Latched, so a detector started later still learns the current demand
+    demand_pub_ = node_.advertise<std_msgs::Bool>(demand_topic, 1, true);
+    std_msgs::Bool demand;
+    demand.data = detections_needed_ = NeedsDetections();
+    demand_pub_.publish(demand);
 }
 
 void HighLevelControl::InitialiseMoveSpecs() {
@@ -96,6 +210,109 @@ void HighLevelControl::InitialiseMoveSpecs() {
         loaded = false;
     }
 
+    if (!node_.getParam("/deskew_scans",
+                        deskew_scans_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/laser_offset",
+                        laser_offset_)) {
+        loaded = false;
+    }
+    deskewer_.SetParams(laser_offset_);
+
+    if (!node_.getParam("/contact_distance",
+                        move_specs_.contact_distance_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/approach_velocity",
+                        move_specs_.approach_velocity_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/approach_deceleration",
+                        move_specs_.approach_deceleration_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/robot_width",
+                        move_specs_.robot_width_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/hit_distance",
+                        move_specs_.hit_distance_)) {
+        loaded = false;
+    }
+
+    double map_resolution, map_max_range;
+    int map_max_beams;
+    if (!node_.getParam("/map_enabled",
+                        map_enabled_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/map_resolution",
+                        map_resolution)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/map_max_range",
+                        map_max_range)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/map_max_beams",
+                        map_max_beams)) {
+        loaded = false;
+    }
+    map_.SetParams(map_resolution, map_max_range, map_max_beams, laser_offset_);
+
+    if (!node_.getParam("/explore_mode",
+                        explore_mode_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/frontier_min_size",
+                        frontier_min_size_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/frontier_gain_weight",
+                        frontier_gain_weight_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/plan_to_goal",
+                        plan_to_goal_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/goal_x",
+                        goal_x_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/goal_y",
+                        goal_y_)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/goal_in_map",
+                        goal_in_map_)) {
+        loaded = false;
+    }
+    // The path keeps the whole robot off the obstacles and prefers to stay
+    // a security distance further away, where the robot need not stop
+    planner_.SetParams(move_specs_.robot_width_ / 2, move_specs_.high_security_distance_);
+    if (!goal_in_map_) {
+        odom_goal_x_ = goal_x_;
+        odom_goal_y_ = goal_y_;
+        has_odom_goal_ = true;
+        planner_.SetGoal(goal_x_, goal_y_);
+    }
+
     move_specs_.turn_type_ = NONE;
 
     if (loaded == false) {
@@ -125,14 +342,44 @@ void HighLevelControl::InitialiseMoveStatus() {
 }
 
 void HighLevelControl::LaserCallback(const sensor_msgs::LaserScan::ConstPtr &msg) {
-    std::vector<float> ranges(msg->ranges.begin(), msg->ranges.end());
+    std::vector<float> ranges;
+    if (deskew_scans_) {
+        // Without odometry the robot is taken to move as it was told to
+        if (have_odometry_) {
+            deskewer_.Deskew(*msg, odom_linear_velocity_, odom_angular_velocity_, ranges);
+        } else {
+            deskewer_.Deskew(*msg, commanded_linear_velocity_, commanded_angular_velocity_, ranges);
+        }
+    } else {
+        ranges.assign(msg->ranges.begin(), msg->ranges.end());
+    }
+    if (map_enabled_ && have_odometry_) {
+        // The scan goes into the map from where the robot was when it was
+        // taken. Deskewed ranges are seen from the end of the sweep
+        Pose2D scan_pose = odom_pose_;
+        if (!msg->header.stamp.isZero()) {
+            double stamp = msg->header.stamp.toSec();
+            if (deskew_scans_ && !ranges.empty()) {
+                stamp += (ranges.size() - 1) * msg->time_increment;
+            }
+            pose_history_.PoseAt(stamp, scan_pose);
+        }
+        map_.Update(scan_pose, ranges, msg->angle_min, msg->angle_increment, msg->range_max);
+    }
 
     if (!move_status_.circle_hit_mode_) {
         Update(ranges);
-        WallFollowMove();
+        if (Planning()) {
+            PlanMove(ranges);
+        } else if (Exploring()) {
+            ExploreMove();
+        } else {
+            WallFollowMove();
+        }
     } else {
         HitCircle(ranges);
     }
+    UpdateDetectionDemand();
 
     // Log robot status
     ROS_INFO("can_continue:%d, is_following_wall:%d, is_close_to_wall:%d, turn_type:%d\n",
@@ -142,18 +389,182 @@ void HighLevelControl::LaserCallback(const sensor_msgs::LaserScan::ConstPtr &msg
 
 void HighLevelControl::CircleCallback(const robot::circle_detect_msg::ConstPtr& msg) {
     std::vector<float> ranges(msg->ranges.begin(), msg->ranges.end());
-    circle_x_ = msg->circle_x;
-    circle_y_ = msg->circle_y;
-    // If true stay in the mode else check if we can hit circle
-    move_status_.circle_hit_mode_ = move_status_.circle_hit_mode_ ? true :
-                                    CanHit(msg->circle_x, msg->circle_y,
-                                           ranges);
+    // The circles were seen from where the robot was when the scan was taken,
+    // move them to where it is now
+    robot::circle_detect_msg detection = *msg;
+    MoveDetection(detection);
+
+    // If true stay in the mode and keep to the chosen circle else check if we
+    // can hit one of the circles
+    if (move_status_.circle_hit_mode_) {
+        FollowCircle(detection);
+    } else {
+        move_status_.circle_hit_mode_ = ChooseCircle(detection, ranges);
+    }
+    // The odometry moves the circle from here on until the next detection
+    circle_pose_ = odom_pose_;
+    UpdateDetectionDemand();
 
     // Log circle coordinates
-    ROS_INFO("circle_x:%lf, circle_y:%lf", circle_x_, circle_y_);
+    ROS_INFO("circle_x:%lf, circle_y:%lf, candidates:%d", circle_x_, circle_y_,
+             static_cast<int>(msg->candidates.size()));
+}
+
+void HighLevelControl::OdomCallback(const nav_msgs::Odometry::ConstPtr& msg) {
+    const geometry_msgs::Quaternion& orientation = msg->pose.pose.orientation;
+    Pose2D pose;
+    pose.x_ = msg->pose.pose.position.x;
+    pose.y_ = msg->pose.pose.position.y;
+    pose.theta_ = YawFromQuaternion(orientation.x, orientation.y,
+                                    orientation.z, orientation.w);
+    if (!have_odometry_) {
+        circle_pose_ = pose;
+        have_odometry_ = true;
+    }
+    PropagateCircle(pose);
+    odom_pose_ = pose;
+    pose_history_.Add(msg->header.stamp.toSec(), pose);
+    odom_linear_velocity_ = msg->twist.twist.linear.x;
+    odom_angular_velocity_ = msg->twist.twist.angular.z;
+}
+
+void HighLevelControl::MapPoseCallback(const nav_msgs::Odometry::ConstPtr& msg) {
+    double spread = std::sqrt(msg->pose.covariance[0] + msg->pose.covariance[7]);
+    if (spread >= localised_spread) {
+        return;
+    }
+    const geometry_msgs::Quaternion& orientation = msg->pose.pose.orientation;
+    map_fix_.x_ = msg->pose.pose.position.x;
+    map_fix_.y_ = msg->pose.pose.position.y;
+    map_fix_.theta_ = YawFromQuaternion(orientation.x, orientation.y,
+                                        orientation.z, orientation.w);
+    // The fix belongs to the scan it was found with, so it is tied to the
+    // odometry pose of that scan where the history reaches back to it
+    map_fix_odom_ = odom_pose_;
+    pose_history_.PoseAt(msg->header.stamp.toSec(), map_fix_odom_);
+    if (!localised_) {
+        ROS_INFO("Localised at x:%lf, y:%lf, theta:%lf", map_fix_.x_, map_fix_.y_,
+                 map_fix_.theta_);
+    }
+    localised_ = true;
+}
+
+bool HighLevelControl::GetMapPose(Pose2D& pose) const {
+    if (!localised_) {
+        return false;
+    }
+    pose = ComposePose(map_fix_, RelativePose(map_fix_odom_, odom_pose_));
+    return true;
+}
+
+void HighLevelControl::PropagateCircle(const Pose2D& pose) {
+    if (circle_x_ > -9) {
+        double x = circle_x_, y = circle_y_;
+        MoveCirclePoint(RelativePose(circle_pose_, pose), laser_offset_, x, y);
+        circle_x_ = x;
+        circle_y_ = y;
+    }
+    circle_pose_ = pose;
+}
+
+void HighLevelControl::MoveDetection(robot::circle_detect_msg& msg) {
+    Pose2D scan_pose;
+    if (!have_odometry_ || msg.header.stamp.isZero()
+            || !pose_history_.PoseAt(msg.header.stamp.toSec(), scan_pose)) {
+        return;
+    }
+    Pose2D motion = RelativePose(scan_pose, odom_pose_);
+    if (msg.circle_x > -9) {
+        MoveCirclePoint(motion, laser_offset_, msg.circle_x, msg.circle_y);
+    }
+    for (size_t i = 0; i < msg.candidates.size(); ++i) {
+        MoveCirclePoint(motion, laser_offset_, msg.candidates[i].x,
+                        msg.candidates[i].y);
+    }
+}
+
+bool HighLevelControl::ChooseCircle(const robot::circle_detect_msg& msg,
+                                    std::vector<float>& ranges) {
+    circle_x_ = msg.circle_x;
+    circle_y_ = msg.circle_y;
+    follow_misses_ = 0;
+    ScanToPoints(ranges, scan_x_, scan_y_);
+    if (CircleInReach(msg.circle_x, msg.circle_y, ranges)) {
+        return true;
+    }
+
+    // The candidates come most confident first, so the first one we can hit
+    // is the best choice
+    for (size_t i = 0; i < msg.candidates.size(); ++i) {
+        if (CircleInReach(msg.candidates[i].x, msg.candidates[i].y, ranges)) {
+            circle_x_ = msg.candidates[i].x;
+            circle_y_ = msg.candidates[i].y;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void HighLevelControl::FollowCircle(const robot::circle_detect_msg& msg) {
+    // The circle closest to the chosen one, as long as it is close enough to
+    // be the same circle
+    if (circle_x_ < -9) {
+        return;
+    }
+    double best_distance = follow_gate;
+    int best = -1;
+    for (size_t i = 0; i <= msg.candidates.size(); ++i) {
+        double x = i == 0 ? msg.circle_x : msg.candidates[i - 1].x;
+        double y = i == 0 ? msg.circle_y : msg.candidates[i - 1].y;
+        double distance = hypot(x - circle_x_, y - circle_y_);
+        if (x > -9 && distance < best_distance) {
+            best_distance = distance;
+            best = static_cast<int>(i);
+        }
+    }
+
+    // A missed, skipped or prefiltered scan says nothing about the circle,
+    // the one moved by the odometry is still where it should be. Any other
+    // circle was never checked by CircleInReach
+    if (best < 0) {
+        if (++follow_misses_ > max_follow_misses) {
+            ROS_INFO("Lost the goal!");
+            circle_x_ = -10;
+            circle_y_ = -10;
+        }
+        return;
+    }
+
+    follow_misses_ = 0;
+    circle_x_ = best == 0 ? msg.circle_x : msg.candidates[best - 1].x;
+    circle_y_ = best == 0 ? msg.circle_y : msg.candidates[best - 1].y;
+}
+
+bool HighLevelControl::NeedsDetections() {
+    // CanHit rejects every circle until a wall is followed. In hit mode the
+    // detections steer the robot to the circle
+    return move_specs_.turn_type_ != NONE && !move_status_.reached_goal_;
+}
+
+void HighLevelControl::UpdateDetectionDemand() {
+    bool needed = NeedsDetections();
+    if (needed == detections_needed_) {
+        return;
+    }
+    detections_needed_ = needed;
+    std_msgs::Bool demand;
+    demand.data = needed;
+    demand_pub_.publish(demand);
 }
 
 bool HighLevelControl::CanHit(double circle_x, double circle_y, std::vector<float>& ranges) {
+    ScanToPoints(ranges, scan_x_, scan_y_);
+    return CircleInReach(circle_x, circle_y, ranges);
+}
+
+bool HighLevelControl::CircleInReach(double circle_x, double circle_y,
+                                     std::vector<float>& ranges) {
     // Cannot hit circle if not in wall following mode
     if (move_specs_.turn_type_ == NONE) {
         return false;
@@ -161,41 +572,40 @@ bool HighLevelControl::CanHit(double circle_x, double circle_y, std::vector<floa
 
     int size = ranges.size();
 
-    // Distance to the wall 20 deg on the opposite side of the circle
-    double wall_20;
     // Planar distance to the center of the circle ignoring obstacles
     double center_distance = sqrt(circle_x * circle_x + circle_y * circle_y);
+    if (circle_y <= 0 || center_distance > move_specs_.hit_distance_) {
+        return false;
+    }
     // Angle to the center of the circle relative to normal Cartesian system
     double center_angle = acos(circle_x / center_distance) / M_PI * 180;
     // Index of the angle in the ranges vector
     int index = static_cast<int>((center_angle + 30) / 240.0 * size);
-    // Check if we might get an out of bound index after shifting by 20 deg
-    int deg20 = static_cast<int>(20.0 / 240.0 * size);
-    if (index < deg20 || index >= size - deg20)
+    if (index < 0 || index >= size)
         return false;
-    // Distance from LRF in the direction of the circle center
+    // Distance from LRF in the direction of the circle center. If it reaches
+    // past the center there is no circle
     double center_lrf = ranges[index];
-    if (move_specs_.turn_type_ == RIGHT) {
-        // Distance 20 deg left from the center
-        wall_20 = ranges[index + deg20];
-    } else if (move_specs_.turn_type_ == LEFT) {
-        // Distance 20 deg right from the center
-        wall_20 = ranges[index - deg20];
-    } else {
+    if (!(center_lrf < center_distance)) {
         return false;
     }
 
-    // Threshold to detect if we have fake circle at a corner. If this is the
-    // case wall_20 will be smaller than the threshold
-    double threshold = center_distance + 1;
-    // If the threshold condition is true, if the circle is to the front of the
-    // robot and close enough then we go into circle hit mode
-    if (wall_20 > threshold && center_lrf < center_distance && circle_x > -0.5
-            && circle_x < 0.5 && circle_y < 1 && circle_y > 0) {
-        return true;
+    // The wall followed is on one side anyway, so the other side tells a
+    // fake circle at a corner from a real one
+    int side = static_cast<int>(corner_check_angle / 240.0 * size);
+    int side_index = move_specs_.turn_type_ == RIGHT ? index + side : index - side;
+    if (side_index < 0 || side_index >= size
+            || !(ranges[side_index] > center_distance + corner_clearance)) {
+        return false;
     }
 
-    return false;
+    // Drive towards the circle as far as it is seen and check nothing else
+    // is in the way
+    double path = center_lrf - corridor_margin;
+    double share = path / center_distance;
+    double free_distance = CorridorFreeDistance(scan_x_, scan_y_, share * circle_x,
+                                                share * circle_y, move_specs_.robot_width_ / 2);
+    return free_distance >= path;
 }
 
 void HighLevelControl::Update(std::vector<float>& ranges) {
@@ -272,7 +682,10 @@ void HighLevelControl::IsCloseToWall(double right_min_distance, double left_min_
 
 void HighLevelControl::HitCircle(std::vector<float>& ranges) {
 
-    if (move_status_.hit_goal_) {
+    // The approach steers towards the circle itself, so the robot only has
+    // to align to the wall if it has lost the circle
+    if (move_status_.hit_goal_ || circle_x_ > -9) {
+        move_status_.hit_goal_ = true;
         GoToCircle(ranges);
         return;
     }
@@ -281,15 +694,16 @@ void HighLevelControl::HitCircle(std::vector<float>& ranges) {
 }
 
 void HighLevelControl::GoToCircle(std::vector<float>& ranges) {
+    int size = ranges.size();
 
-    // 30 degree in front of the robot to detect if the circle has been hit
-    float right_10 = (110.0 / 240.0) * ranges.size();
-    float left_10 = (130.0 / 240.0) * ranges.size();
+    // 20 degree in front of the robot to detect if the circle has been hit
+    float right_10 = (110.0 / 240.0) * size;
+    float left_10 = (130.0 / 240.0) * size;
     float center_min = GetMin(ranges, right_10, left_10);
 
     ROS_INFO("center_min:%f", center_min);
 
-    if (center_min < 0.15) {
+    if (center_min < move_specs_.contact_distance_) {
         ROS_INFO("Goal Reached!");
         // This is the only instance when the robot does not move after
         // all nodes have been initialized
@@ -298,34 +712,36 @@ void HighLevelControl::GoToCircle(std::vector<float>& ranges) {
         return;
     }
 
-    if (move_status_.is_sim_) {
-        // Move fast towards goal
-        float angular_velocity;
-        if (move_specs_.turn_type_ == LEFT) {
-            angular_velocity = 0.25;
-        } else {
-            angular_velocity = -0.25;
-        }
-        ROS_INFO("Moving towards the goal!");
-        Move(move_specs_.linear_velocity_ * 10, angular_velocity);
+    // The robot has to be able to stop before it touches whatever is in
+    // its way, the circle included. Without a circle that is anything in front
+    double free_distance;
+    if (circle_x_ > -9) {
+        ScanToPoints(ranges, scan_x_, scan_y_);
+        free_distance = CorridorFreeDistance(scan_x_, scan_y_, circle_x_, circle_y_,
+                                             move_specs_.robot_width_ / 2);
+    } else {
+        float right_limit = (move_specs_.right_limit_ / 240.0) * size;
+        float left_limit = (move_specs_.left_limit_ / 240.0) * size;
+        free_distance = GetMin(ranges, right_limit, left_limit);
+    }
+    free_distance -= move_specs_.contact_distance_;
+    double linear_velocity = ApproachVelocity(free_distance,
+                             min_approach_share * move_specs_.approach_velocity_,
+                             move_specs_.approach_velocity_,
+                             move_specs_.approach_deceleration_);
+
+    if (circle_x_ < -9) {
+        ROS_INFO("Moving towards the lost goal!");
+        Move(linear_velocity, 0);
         return;
     }
 
-    float low_lim = -0.05, high_lim = 0.05;
-
-    if (circle_x_ < -9 || (circle_x_ <= high_lim && circle_x_ >= low_lim)) {
-        ROS_INFO("Circle Case: 0!");
-        Move(move_specs_.linear_velocity_ , 0);
-    } else if (circle_x_ > high_lim && circle_y_ < 1 && circle_y_ > 0) {
-        ROS_INFO("Circle Case: 1!");
-        Move(0, -move_specs_.angular_velocity_);
-    } else if (circle_x_ < low_lim && circle_y_ < 1 && circle_y_ > 0) {
-        ROS_INFO("Circle Case: 2!");
-        Move(0, move_specs_.angular_velocity_);
-    } else {
-        ROS_INFO("Circle Case: 3!");
-        Move(move_specs_.linear_velocity_ , 0);
-    }
+    // The circle coordinates have x to the right and y forward
+    double angular_velocity;
+    ArcVelocities(circle_y_, -circle_x_, move_specs_.angular_velocity_, linear_velocity,
+                  angular_velocity);
+    ROS_INFO("Moving towards the goal: %f %f", linear_velocity, angular_velocity);
+    Move(linear_velocity, angular_velocity);
 }
 
 void HighLevelControl::AlignRobot(std::vector<float>& ranges) {
@@ -366,8 +782,7 @@ void HighLevelControl::WallFollowMove() {
     if (!move_status_.can_continue_ && !move_status_.is_following_wall_) {
         srand(time(NULL));
 
-        // 50% left mode, 50% right mode
-        move_specs_.turn_type_ = rand() % 10000 > 5000 ? RIGHT : LEFT;
+        move_specs_.turn_type_ = ChooseTurnType();
         move_status_.is_following_wall_ = true;
     } else if (move_status_.can_continue_ && !move_status_.is_following_wall_) {
     	ROS_INFO("The robot can continue walking!\n");
@@ -421,6 +836,196 @@ void HighLevelControl::WallFollowMove() {
     BreakRotation();
 }
 
+TurnType HighLevelControl::ChooseTurnType() {
+    if (map_enabled_ && have_odometry_) {
+        int right = map_.UnknownAlong(odom_pose_.x_, odom_pose_.y_,
+                                      odom_pose_.theta_ - explore_angle, explore_distance);
+        int left = map_.UnknownAlong(odom_pose_.x_, odom_pose_.y_,
+                                     odom_pose_.theta_ + explore_angle, explore_distance);
+        ROS_INFO("Unknown space right:%d, left:%d", right, left);
+        if (right != left) {
+            return right > left ? RIGHT : LEFT;
+        }
+    }
+
+    // 50% left mode, 50% right mode
+    return rand() % 10000 > 5000 ? RIGHT : LEFT;
+}
+
+bool HighLevelControl::Exploring() {
+    return explore_mode_ && map_enabled_ && have_odometry_;
+}
+
+void HighLevelControl::PickFrontier() {
+    std::vector<Frontier> frontiers;
+    map_.FindFrontiers(frontier_min_size_, frontiers);
+
+    has_frontier_ = false;
+    explore_scans_ = 0;
+    blocked_scans_ = 0;
+    double best_score = 0;
+    for (size_t i = 0; i < frontiers.size(); ++i) {
+        double distance = hypot(frontiers[i].x_ - odom_pose_.x_, frontiers[i].y_ - odom_pose_.y_);
+        if (distance < frontier_reached_distance) {
+            continue;
+        }
+        bool unreachable = false;
+        for (size_t j = 0; j < unreachable_frontiers_.size() && !unreachable; ++j) {
+            unreachable = hypot(frontiers[i].x_ - unreachable_frontiers_[j].x_,
+                                frontiers[i].y_ - unreachable_frontiers_[j].y_) < unreachable_radius;
+        }
+        if (unreachable) {
+            continue;
+        }
+
+        // The length of the frontier against the way there
+        double score = frontier_gain_weight_ * frontiers[i].size_ * map_.Resolution() - distance;
+        if (!has_frontier_ || score > best_score) {
+            has_frontier_ = true;
+            best_score = score;
+            frontier_ = frontiers[i];
+        }
+    }
+    ROS_INFO("Frontiers:%d, picked:%d", static_cast<int>(frontiers.size()), has_frontier_);
+}
+
+void HighLevelControl::ExploreMove() {
+    // CanHit only takes circles while a wall side is chosen
+    if (move_specs_.turn_type_ == NONE) {
+        move_specs_.turn_type_ = ChooseTurnType();
+    }
+
+    if (!has_frontier_ || ++explore_scans_ >= frontier_replan_scans
+            || hypot(frontier_.x_ - odom_pose_.x_, frontier_.y_ - odom_pose_.y_)
+            < frontier_reached_distance) {
+        PickFrontier();
+    }
+    if (!has_frontier_) {
+        // Nothing left to explore that can be reached
+        WallFollowMove();
+        return;
+    }
+
+    if (!move_status_.can_continue_) {
+        ROS_INFO("The way to the frontier is blocked!\n");
+        Move(0, (move_specs_.turn_type_ - 1) * move_specs_.angular_velocity_);
+        if (++blocked_scans_ > max_blocked_scans) {
+            unreachable_frontiers_.push_back(frontier_);
+            has_frontier_ = false;
+        }
+        return;
+    }
+    blocked_scans_ = 0;
+    MoveTowards(frontier_.x_, frontier_.y_);
+}
+
+bool HighLevelControl::Planning() {
+    return plan_to_goal_ && map_enabled_ && have_odometry_ && !plan_finished_;
+}
+
+void HighLevelControl::PlanMove(std::vector<float>& ranges) {
+    // CanHit only takes circles while a wall side is chosen
+    if (move_specs_.turn_type_ == NONE) {
+        move_specs_.turn_type_ = ChooseTurnType();
+    }
+
+    if (!UpdateGoal()) {
+        ROS_INFO("Not localised, no goal yet!");
+        WallFollowMove();
+        return;
+    }
+
+    if (hypot(odom_goal_x_ - odom_pose_.x_, odom_goal_y_ - odom_pose_.y_)
+            < goal_reached_distance) {
+        ROS_INFO("Reached the goal!");
+        plan_finished_ = true;
+        Move(0, 0);
+        return;
+    }
+
+    if (path_x_.empty() || ++plan_scans_ >= plan_replan_scans || blocked_scans_ > 0) {
+        plan_scans_ = 0;
+        planner_.Plan(map_, odom_pose_.x_, odom_pose_.y_, path_x_, path_y_);
+    }
+    if (path_x_.empty()) {
+        // The map may still open a way
+        ROS_INFO("No path to the goal!");
+        WallFollowMove();
+        return;
+    }
+
+    // The waypoint closest to the robot, then the first one far enough on
+    size_t closest = 0;
+    double closest_distance = hypot(path_x_[0] - odom_pose_.x_, path_y_[0] - odom_pose_.y_);
+    for (size_t i = 1; i < path_x_.size(); ++i) {
+        double distance = hypot(path_x_[i] - odom_pose_.x_, path_y_[i] - odom_pose_.y_);
+        if (distance < closest_distance) {
+            closest = i;
+            closest_distance = distance;
+        }
+    }
+    size_t waypoint = closest;
+    while (waypoint + 1 < path_x_.size()
+            && hypot(path_x_[waypoint] - odom_pose_.x_, path_y_[waypoint] - odom_pose_.y_)
+            < plan_lookahead) {
+        ++waypoint;
+    }
+
+    // The path keeps clear of the walls, so only something in the way of the
+    // robot to the waypoint blocks it, not a wall beside a narrow corridor
+    Pose2D point = MakePose(path_x_[waypoint], path_y_[waypoint], odom_pose_.theta_);
+    Pose2D target = RelativePose(odom_pose_, point);
+    if (target.x_ > 0) {
+        ScanToPoints(ranges, scan_x_, scan_y_);
+        double length = hypot(target.x_, target.y_);
+        double free_distance = CorridorFreeDistance(scan_x_, scan_y_, -target.y_, target.x_,
+                                                    move_specs_.robot_width_ / 2);
+        if (free_distance < std::min(length, move_specs_.high_security_distance_)) {
+            ROS_INFO("The way to the goal is blocked!\n");
+            Move(0, (move_specs_.turn_type_ - 1) * move_specs_.angular_velocity_);
+            if (++blocked_scans_ > max_blocked_scans) {
+                ROS_INFO("Gave up the goal!");
+                plan_finished_ = true;
+            }
+            return;
+        }
+    }
+    blocked_scans_ = 0;
+    MoveTowards(path_x_[waypoint], path_y_[waypoint]);
+}
+
+bool HighLevelControl::UpdateGoal() {
+    Pose2D map_pose;
+    if (!goal_in_map_ || !GetMapPose(map_pose)) {
+        return has_odom_goal_;
+    }
+
+    // The goal as seen from the robot is the same in both frames
+    Pose2D goal = MakePose(goal_x_, goal_y_, 0);
+    Pose2D odom_goal = ComposePose(odom_pose_, RelativePose(map_pose, goal));
+    if (has_odom_goal_ && hypot(odom_goal.x_ - odom_goal_x_, odom_goal.y_ - odom_goal_y_)
+            < goal_shift_tolerance) {
+        return true;
+    }
+    odom_goal_x_ = odom_goal.x_;
+    odom_goal_y_ = odom_goal.y_;
+    has_odom_goal_ = true;
+    planner_.SetGoal(odom_goal_x_, odom_goal_y_);
+    path_x_.clear();
+    path_y_.clear();
+    return true;
+}
+
+void HighLevelControl::MoveTowards(double x, double y) {
+    Pose2D point = MakePose(x, y, odom_pose_.theta_);
+    Pose2D target = RelativePose(odom_pose_, point);
+    double linear_velocity = move_specs_.linear_velocity_, angular_velocity;
+    ArcVelocities(target.x_, target.y_, move_specs_.angular_velocity_, linear_velocity,
+                  angular_velocity);
+    ROS_INFO("Moving towards the target: %f %f", linear_velocity, angular_velocity);
+    Move(linear_velocity, angular_velocity);
+}
+
 void HighLevelControl::BreakRotation() {
     // In place breaking condition is relative to the angular velocity with
     // which we are turning
@@ -463,4 +1068,6 @@ void HighLevelControl::Move(double linear_velocity, double angular_velocity) {
     msg.linear.x = linear_velocity;
     msg.angular.z = angular_velocity;
     cmd_vel_pub_.publish(msg);
+    commanded_linear_velocity_ = linear_velocity;
+    commanded_angular_velocity_ = angular_velocity;
 }
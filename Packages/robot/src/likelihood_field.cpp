@@ -0,0 +1,183 @@
+/**
+ * @file likelihood_field.cpp
+ * @brief This file contains the implementation of the likelihood of a laser
+ * beam ending at a point of a known map.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "likelihood_field.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+// Share of the beams that end at an obstacle of the map and of those that
+// end anywhere, at people, unmapped objects or the circle
+const double hit_share = 0.9;
+const double random_share = 0.1;
+
+// Squared distance of a cell without an obstacle in its row or column, big
+// enough to never be the minimum but not overflowing when squares are added
+const double no_obstacle = 1e12;
+
+// Position where the parabolas rooted at cells q and r of a line cross
+double Intersection(const std::vector<double>& f, int q, int r) {
+    return ((f[q] + static_cast<double>(q) * q) - (f[r] + static_cast<double>(r) * r))
+           / (2.0 * (q - r));
+}
+
+// Exact squared distance transform along one line of the map, by the lower
+// envelope of the parabolas rooted at every cell (Felzenszwalb and
+// Huttenlocher). f holds the squared distances so far and gets the new ones
+void DistanceTransform(std::vector<double>& f, std::vector<int>& roots,
+                       std::vector<double>& bounds, std::vector<double>& result) {
+    int size = f.size();
+    if (size == 0) {
+        return;
+    }
+    roots.resize(size);
+    bounds.resize(size + 1);
+    result.resize(size);
+    int k = 0;
+    roots[0] = 0;
+    bounds[0] = -std::numeric_limits<double>::infinity();
+    bounds[1] = std::numeric_limits<double>::infinity();
+    for (int q = 1; q < size; ++q) {
+        // Drops the parabolas the new one hides. The first bound is minus
+        // infinity, so this stops at the first parabola at the latest
+        double s = Intersection(f, q, roots[k]);
+        while (s <= bounds[k]) {
+            --k;
+            s = Intersection(f, q, roots[k]);
+        }
+        ++k;
+        roots[k] = q;
+        bounds[k] = s;
+        bounds[k + 1] = std::numeric_limits<double>::infinity();
+    }
+    k = 0;
+    for (int q = 0; q < size; ++q) {
+        while (bounds[k + 1] < q) {
+            ++k;
+        }
+        double d = q - roots[k];
+        result[q] = d * d + f[roots[k]];
+    }
+    f.swap(result);
+}
+
+}
+
+void SquaredDistanceTransform(std::vector<double>& squared, int width, int height) {
+    // First along the columns, then along the rows using the column distances
+    std::vector<double> line, result, bounds;
+    std::vector<int> roots;
+    for (int x = 0; x < width; ++x) {
+        line.resize(height);
+        for (int y = 0; y < height; ++y) {
+            line[y] = squared[y * width + x];
+        }
+        DistanceTransform(line, roots, bounds, result);
+        for (int y = 0; y < height; ++y) {
+            squared[y * width + x] = line[y];
+        }
+    }
+    for (int y = 0; y < height; ++y) {
+        line.assign(squared.begin() + y * width, squared.begin() + (y + 1) * width);
+        DistanceTransform(line, roots, bounds, result);
+        std::copy(line.begin(), line.end(), squared.begin() + y * width);
+    }
+}
+
+LikelihoodField::LikelihoodField() : width_(0), height_(0), resolution_(0.05),
+    origin_x_(0), origin_y_(0) {
+}
+
+void LikelihoodField::SetMap(const std::vector<unsigned char>& occupied, int width, int height,
+                             double resolution, double origin_x, double origin_y,
+                             double hit_sigma) {
+    width_ = width;
+    height_ = height;
+    resolution_ = resolution;
+    origin_x_ = origin_x;
+    origin_y_ = origin_y;
+
+    std::vector<double> squared(width * height);
+    for (int i = 0; i < width * height; ++i) {
+        squared[i] = occupied[i] ? 0 : no_obstacle;
+    }
+    SquaredDistanceTransform(squared, width, height);
+
+    // The Gaussian is taken per metre of beam end, so the share of random
+    // returns compares to it the same for every resolution
+    double normaliser = 1 / (std::sqrt(2 * M_PI) * hit_sigma);
+    float outside = static_cast<float>(std::log(random_share));
+    distance_.resize(width * height);
+    log_likelihood_.assign((width + 2) * (height + 2), outside);
+    free_cells_.clear();
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int cell = y * width + x;
+            double distance = std::sqrt(squared[cell]) * resolution;
+            distance_[cell] = static_cast<float>(distance);
+            double hit = normaliser * std::exp(-distance * distance / (2 * hit_sigma * hit_sigma));
+            log_likelihood_[(y + 1) * (width + 2) + x + 1] =
+                static_cast<float>(std::log(hit_share * hit + random_share));
+            if (!occupied[cell]) {
+                free_cells_.push_back(cell);
+            }
+        }
+    }
+}
+
+bool LikelihoodField::HasMap() const {
+    return width_ > 0 && height_ > 0;
+}
+
+double LikelihoodField::Distance(double x, double y) const {
+    int cell_x = static_cast<int>(std::floor((x - origin_x_) / resolution_));
+    int cell_y = static_cast<int>(std::floor((y - origin_y_) / resolution_));
+    if (cell_x < 0 || cell_x >= width_ || cell_y < 0 || cell_y >= height_) {
+        return 0;
+    }
+    return distance_[cell_y * width_ + cell_x];
+}
+
+float LikelihoodField::SumLogLikelihood(const float* x, const float* y, int count) const {
+    // Points outside the map are clamped onto the border, which holds the
+    // likelihood of random returns, so there is no branch per point
+    float scale = static_cast<float>(1 / resolution_);
+    float start_x = static_cast<float>(1 - origin_x_ / resolution_);
+    float start_y = static_cast<float>(1 - origin_y_ / resolution_);
+    float last_x = static_cast<float>(width_ + 1), last_y = static_cast<float>(height_ + 1);
+    int stride = width_ + 2;
+    const float* field = &log_likelihood_[0];
+    float sum = 0;
+    for (int i = 0; i < count; ++i) {
+        float cell_x = std::min(std::max(x[i] * scale + start_x, 0.0f), last_x);
+        float cell_y = std::min(std::max(y[i] * scale + start_y, 0.0f), last_y);
+        sum += field[static_cast<int>(cell_y) * stride + static_cast<int>(cell_x)];
+    }
+    return sum;
+}
+
+const std::vector<int>& LikelihoodField::FreeCells() const {
+    return free_cells_;
+}
+
+void LikelihoodField::CellCentre(int cell, double& x, double& y) const {
+    x = origin_x_ + (cell % width_ + 0.5) * resolution_;
+    y = origin_y_ + (cell / width_ + 0.5) * resolution_;
+}
+
+double LikelihoodField::Resolution() const {
+    return resolution_;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file load_governor.cpp
+ * @brief This file contains the implementation of the governor that
+ * degrades the circle detector when it cannot keep up with the scans.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "load_governor.h"
+
+LoadGovernor::LoadGovernor() : level_(LOAD_NORMAL), load_(-1), hold_(0), calm_frames_(0) {
+    params_.enabled_ = false;
+    params_.overload_ = 1;
+    params_.headroom_ = 0;
+    params_.smoothing_ = 1;
+    params_.hold_frames_ = 0;
+}
+
+void LoadGovernor::SetParams(const GovernorParams& params) {
+    params_ = params;
+    if (!params_.enabled_) {
+        Reset();
+    }
+}
+
+void LoadGovernor::Reset() {
+    level_ = LOAD_NORMAL;
+    load_ = -1;
+    hold_ = 0;
+    calm_frames_ = 0;
+}
+
+int LoadGovernor::Update(double processing_time, double available_time) {
+    if (!params_.enabled_ || available_time <= 0) {
+        return level_;
+    }
+
+    double load = processing_time / available_time;
+    load_ = load_ < 0 ? load : load_ + params_.smoothing_ * (load - load_);
+
+    //let the average settle at the new level first
+    if (hold_ > 0) {
+        --hold_;
+        return level_;
+    }
+
+    if (load_ > params_.overload_) {
+        calm_frames_ = 0;
+        if (level_ < LOAD_CHEAP_BACKEND) {
+            ++level_;
+            hold_ = params_.hold_frames_;
+        }
+    } else if (load_ < params_.headroom_ && level_ > LOAD_NORMAL) {
+        if (++calm_frames_ >= params_.hold_frames_) {
+            --level_;
+            hold_ = params_.hold_frames_;
+            calm_frames_ = 0;
+        }
+    } else {
+        calm_frames_ = 0;
+    }
+    return level_;
+}
+
+int LoadGovernor::Level() const {
+    return level_;
+}
+
+double LoadGovernor::Load() const {
+    return load_;
+}
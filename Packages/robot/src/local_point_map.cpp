@@ -0,0 +1,70 @@
+/**
+ * @file local_point_map.cpp
+ * @brief This file contains the implementation of the rolling map of the last
+ * few laser scans.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "local_point_map.h"
+#include "pose_helpers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+LocalPointMap::LocalPointMap() : next_(0), count_(0), laser_offset_(0) {
+}
+
+void LocalPointMap::SetLaserOffset(double laser_offset) {
+    laser_offset_ = laser_offset;
+}
+
+void LocalPointMap::SetCapacity(int scans) {
+    size_t capacity = static_cast<size_t>(std::max(0, scans));
+    if (capacity != frames_.size()) {
+        frames_.resize(capacity);
+        Clear();
+    }
+}
+
+void LocalPointMap::Clear() {
+    next_ = 0;
+    count_ = 0;
+}
+
+void LocalPointMap::Add(const std::vector<cv::Point2f>& points, const Pose2D& pose) {
+    if (frames_.empty()) {
+        return;
+    }
+
+    //The vectors of overwritten frames keep their memory
+    Frame& frame = frames_[next_];
+    frame.pose_ = pose;
+    frame.points_.assign(points.begin(), points.end());
+    next_ = (next_ + 1) % frames_.size();
+    count_ = std::min(count_ + 1, frames_.size());
+}
+
+void LocalPointMap::Collect(const Pose2D& pose, std::vector<cv::Point2f>& points) const {
+    points.clear();
+    for (size_t i = 0; i < count_; ++i) {
+        const Frame& frame = frames_[i];
+        Pose2D motion = LaserMotion(RelativePose(frame.pose_, pose), laser_offset_);
+        double cos_theta = std::cos(motion.theta_), sin_theta = std::sin(motion.theta_);
+
+        //Same as TransformToMovedFrame in the ROS frame, written out for the
+        //detector frame, which has x = -y and y = x
+        for (size_t j = 0; j < frame.points_.size(); ++j) {
+            double dx = frame.points_[j].y - motion.x_;
+            double dy = -frame.points_[j].x - motion.y_;
+            double x = cos_theta * dx + sin_theta * dy;
+            double y = -sin_theta * dx + cos_theta * dy;
+            points.push_back(cv::Point2f(-y, x));
+        }
+    }
+}
@@ -0,0 +1,221 @@
+/**
+ * @file localisation.cpp
+ * @brief This file contains the implementation of the localisation of the
+ * robot in the map of a stage world.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "localisation.h"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+namespace {
+
+// The filter is updated once the robot has driven or turned this far since
+// the last update, so a standing robot does not grow overconfident
+const double update_distance = 0.05;
+const double update_angle = 0.1;
+
+// Pixels darker than this that are not transparent are obstacles
+const int obstacle_brightness = 128;
+const int opaque_alpha = 128;
+
+// Reads the numbers between the brackets of a world file value
+void ReadVector(const std::string& line, std::vector<double>& values) {
+    values.clear();
+    size_t open = line.find('['), close = line.find(']');
+    if (open == std::string::npos || close == std::string::npos) {
+        return;
+    }
+    std::istringstream numbers(line.substr(open + 1, close - open - 1));
+    double value;
+    while (numbers >> value) {
+        values.push_back(value);
+    }
+}
+
+}
+
+Localisation::Localisation() : have_odometry_(false), updated_(false) {
+    odom_pose_ = MakePose(0, 0, 0);
+    update_pose_ = odom_pose_;
+    Initialise();
+}
+
+void Localisation::Initialise() {
+    bool loaded = true;
+    std::string world_file, laser_topic, odom_topic, pose_topic;
+    int min_particles, max_particles, max_beams;
+    double hit_sigma, laser_offset;
+
+    if (!node_.getParam("/localisation_world", world_file)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/localisation_laser_topic", laser_topic)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/localisation_odom_topic", odom_topic)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/localisation_topic", pose_topic)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/localisation_min_particles", min_particles)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/localisation_max_particles", max_particles)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/localisation_max_beams", max_beams)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/localisation_hit_sigma", hit_sigma)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/localisation_laser_offset", laser_offset)) {
+        loaded = false;
+    }
+
+    if (loaded == false) {
+        ROS_INFO("Localisation parameters failed to load!");
+        ros::shutdown();
+        return;
+    }
+
+    std::vector<unsigned char> occupied;
+    int width, height;
+    double resolution, origin_x, origin_y;
+    if (!LoadWorld(world_file, occupied, width, height, resolution, origin_x, origin_y)) {
+        ROS_INFO("Map of %s failed to load!", world_file.c_str());
+        ros::shutdown();
+        return;
+    }
+
+    filter_.SetParams(min_particles, max_particles, max_beams, laser_offset);
+    filter_.SetMap(occupied, width, height, resolution, origin_x, origin_y, hit_sigma);
+    filter_.InitialiseGlobal();
+
+    pose_pub_ = node_.advertise<nav_msgs::Odometry>(pose_topic, 100);
+    odom_sub_ = node_.subscribe(odom_topic, 100, &Localisation::OdomCallback, this);
+    laser_sub_ = node_.subscribe(laser_topic, 100, &Localisation::LaserCallback, this);
+}
+
+bool Localisation::LoadWorld(const std::string& world_file, std::vector<unsigned char>& occupied,
+                             int& width, int& height, double& resolution,
+                             double& origin_x, double& origin_y) {
+    // The floor plan is the floorplan model of the world, not its definition
+    std::ifstream world(world_file.c_str());
+    std::string line, bitmap;
+    std::vector<double> size, pose, values;
+    bool in_floorplan = false;
+    while (std::getline(world, line)) {
+        std::istringstream words(line);
+        std::string key;
+        words >> key;
+        if (key == "floorplan") {
+            in_floorplan = true;
+        } else if (in_floorplan && key == ")") {
+            in_floorplan = false;
+        } else if (in_floorplan && key == "bitmap") {
+            size_t open = line.find('"'), close = line.rfind('"');
+            if (open != close) {
+                bitmap = line.substr(open + 1, close - open - 1);
+            }
+        } else if (in_floorplan && key == "size") {
+            ReadVector(line, size);
+        } else if (in_floorplan && key == "pose") {
+            ReadVector(line, pose);
+        }
+    }
+    if (bitmap.empty() || size.size() < 2) {
+        return false;
+    }
+
+    size_t slash = world_file.rfind('/');
+    std::string directory = slash == std::string::npos ? "" : world_file.substr(0, slash + 1);
+    cv::Mat image = cv::imread(directory + bitmap, cv::IMREAD_UNCHANGED);
+    if (image.empty()) {
+        return false;
+    }
+
+    // Stage stretches the bitmap over the size of the floor plan around its
+    // pose, with the first row of the image at the top
+    width = image.cols;
+    height = image.rows;
+    resolution = size[0] / width;
+    double centre_x = pose.size() >= 2 ? pose[0] : 0, centre_y = pose.size() >= 2 ? pose[1] : 0;
+    origin_x = centre_x - size[0] / 2;
+    origin_y = centre_y - size[1] / 2;
+
+    int channels = image.channels();
+    occupied.assign(width * height, 0);
+    for (int row = 0; row < height; ++row) {
+        const unsigned char* pixel = image.ptr<unsigned char>(row);
+        unsigned char* cells = &occupied[(height - 1 - row) * width];
+        for (int x = 0; x < width; ++x, pixel += channels) {
+            bool dark = pixel[0] < obstacle_brightness;
+            bool opaque = channels < 4 || pixel[3] >= opaque_alpha;
+            bool boundary = x == 0 || row == 0 || x == width - 1 || row == height - 1;
+            cells[x] = (dark && opaque) || boundary;
+        }
+    }
+    return true;
+}
+
+void Localisation::OdomCallback(const nav_msgs::Odometry::ConstPtr& msg) {
+    const geometry_msgs::Quaternion& orientation = msg->pose.pose.orientation;
+    odom_pose_.x_ = msg->pose.pose.position.x;
+    odom_pose_.y_ = msg->pose.pose.position.y;
+    odom_pose_.theta_ = YawFromQuaternion(orientation.x, orientation.y,
+                                          orientation.z, orientation.w);
+    have_odometry_ = true;
+}
+
+void Localisation::LaserCallback(const sensor_msgs::LaserScan::ConstPtr& msg) {
+    if (!have_odometry_) {
+        return;
+    }
+    Pose2D motion = RelativePose(update_pose_, odom_pose_);
+    if (updated_ && std::hypot(motion.x_, motion.y_) < update_distance
+            && std::fabs(motion.theta_) < update_angle) {
+        return;
+    }
+    if (updated_) {
+        filter_.Predict(motion);
+    }
+    filter_.Correct(msg->ranges, msg->angle_min, msg->angle_increment, msg->range_max);
+    update_pose_ = odom_pose_;
+    updated_ = true;
+
+    Pose2D pose = filter_.Estimate();
+    double spread = filter_.Spread();
+    nav_msgs::Odometry localised;
+    localised.header.stamp = msg->header.stamp;
+    localised.header.frame_id = "map";
+    localised.child_frame_id = msg->header.frame_id;
+    localised.pose.pose.position.x = pose.x_;
+    localised.pose.pose.position.y = pose.y_;
+    localised.pose.pose.orientation.z = std::sin(pose.theta_ / 2);
+    localised.pose.pose.orientation.w = std::cos(pose.theta_ / 2);
+    localised.pose.covariance[0] = localised.pose.covariance[7] = spread * spread / 2;
+    pose_pub_.publish(localised);
+}
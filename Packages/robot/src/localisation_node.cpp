@@ -0,0 +1,32 @@
+/** 
+ * @file localisation_node.cpp
+ * @brief This file creates the Localisation ros node which publishes the
+ * pose of the robot in the map of its stage world
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <ros/ros.h>
+#include "localisation.h"
+
+/**
+ * \cond
+ */
+int main(int argc, char** argv)
+{
+    ros::init(argc, argv, "Localisation");
+
+    Localisation localisation;
+
+    ros::spin();
+
+    return 0;
+}
+
+/**
+ * \endcond
+ */
@@ -0,0 +1,306 @@
+/**
+ * @file occupancy_grid.cpp
+ * @brief This file contains the implementation of the map the robot builds
+ * of the space it has seen.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "occupancy_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+// A tile is tile_size x tile_size cells
+const int tile_bits = 5;
+const int tile_size = 1 << tile_bits;
+const int tile_mask = tile_size - 1;
+
+// Change of the log-odds of a cell a beam ends in and one it passes through
+const float log_odds_hit = 0.85f;
+const float log_odds_miss = -0.4f;
+
+// The log-odds stay within this limit, so a cell can change its state again
+const float log_odds_limit = 3.5f;
+
+// A cell with log-odds above this is occupied, below the other one it is free
+const float occupied_log_odds = 0.5f;
+const float free_log_odds = -0.2f;
+
+long long TileKey(int tile_x, int tile_y) {
+    return (static_cast<long long>(tile_x) << 32) | static_cast<unsigned int>(tile_y);
+}
+
+bool IsUnknown(float log_odds) {
+    return log_odds >= free_log_odds && log_odds <= occupied_log_odds;
+}
+
+int CellIndex(int cell_x, int cell_y) {
+    return ((cell_y & tile_mask) << tile_bits) | (cell_x & tile_mask);
+}
+
+void AddLogOdds(float& cell, float change) {
+    cell = std::max(-log_odds_limit, std::min(log_odds_limit, cell + change));
+}
+
+}
+
+OccupancyGrid::OccupancyGrid() : resolution_(0.05), max_range_(4), max_beams_(180),
+    laser_offset_(0), last_key_(0), last_tile_(-1) {
+}
+
+void OccupancyGrid::SetParams(double resolution, double max_range, int max_beams,
+                              double laser_offset) {
+    if (resolution != resolution_) {
+        Clear();
+    }
+    resolution_ = resolution;
+    max_range_ = max_range;
+    max_beams_ = max_beams;
+    laser_offset_ = laser_offset;
+}
+
+void OccupancyGrid::Clear() {
+    tiles_.clear();
+    tile_index_.clear();
+    last_tile_ = -1;
+}
+
+float& OccupancyGrid::Cell(int cell_x, int cell_y) {
+    long long key = TileKey(cell_x >> tile_bits, cell_y >> tile_bits);
+    if (last_tile_ < 0 || key != last_key_) {
+        std::unordered_map<long long, int>::iterator found = tile_index_.find(key);
+        if (found == tile_index_.end()) {
+            found = tile_index_.insert(std::make_pair(key, static_cast<int>(tiles_.size()))).first;
+            tiles_.push_back(std::vector<float>(tile_size * tile_size, 0));
+        }
+        last_key_ = key;
+        last_tile_ = found->second;
+    }
+    return tiles_[last_tile_][CellIndex(cell_x, cell_y)];
+}
+
+const std::vector<float>* OccupancyGrid::FindTile(int cell_x, int cell_y) const {
+    std::unordered_map<long long, int>::const_iterator found =
+        tile_index_.find(TileKey(cell_x >> tile_bits, cell_y >> tile_bits));
+    if (found == tile_index_.end()) {
+        return NULL;
+    }
+    return &tiles_[found->second];
+}
+
+void OccupancyGrid::Update(const Pose2D& pose, const std::vector<float>& ranges,
+                           double angle_min, double angle_increment, double range_max) {
+    int size = ranges.size();
+    if (size == 0 || resolution_ <= 0 || max_beams_ <= 0) {
+        return;
+    }
+    int stride = (size + max_beams_ - 1) / max_beams_;
+    int beams = (size + stride - 1) / stride;
+    end_x_.resize(beams);
+    end_y_.resize(beams);
+    hit_.resize(beams);
+
+    // Where the beams end, computed for all of them at once before they are
+    // followed one by one. Beams without a return are followed as far as
+    // max_range_ and mark nothing as occupied. They start at the laser range
+    // finder, which sits in front of the centre of the robot
+    float start_x = (pose.x_ + laser_offset_ * std::cos(pose.theta_)) / resolution_;
+    float start_y = (pose.y_ + laser_offset_ * std::sin(pose.theta_)) / resolution_;
+    float cell_range = max_range_ / resolution_;
+    float limit = std::min(range_max, max_range_) / resolution_;
+    for (int i = 0; i < beams; ++i) {
+        float range = ranges[i * stride] / resolution_;
+        bool valid = range > 0;
+        hit_[i] = valid && range < limit;
+        range = valid && range < cell_range ? range : cell_range;
+        double angle = pose.theta_ + angle_min + i * stride * angle_increment;
+        end_x_[i] = start_x + range * static_cast<float>(std::cos(angle));
+        end_y_[i] = start_y + range * static_cast<float>(std::sin(angle));
+    }
+
+    for (int i = 0; i < beams; ++i) {
+        TraceBeam(start_x, start_y, end_x_[i], end_y_[i], hit_[i]);
+    }
+}
+
+void OccupancyGrid::TraceBeam(float start_x, float start_y, float end_x, float end_y, bool hit) {
+    // Walks from cell to cell along the beam, always crossing the nearer of
+    // the next vertical and horizontal cell borders
+    int cell_x = static_cast<int>(std::floor(start_x));
+    int cell_y = static_cast<int>(std::floor(start_y));
+    int last_x = static_cast<int>(std::floor(end_x));
+    int last_y = static_cast<int>(std::floor(end_y));
+    float dx = end_x - start_x, dy = end_y - start_y;
+    int step_x = dx > 0 ? 1 : -1, step_y = dy > 0 ? 1 : -1;
+    float infinity = std::numeric_limits<float>::infinity();
+    float delta_x = dx != 0 ? std::fabs(1 / dx) : infinity;
+    float delta_y = dy != 0 ? std::fabs(1 / dy) : infinity;
+    float next_x = dx == 0 ? infinity
+                   : (dx > 0 ? cell_x + 1 - start_x : start_x - cell_x) * delta_x;
+    float next_y = dy == 0 ? infinity
+                   : (dy > 0 ? cell_y + 1 - start_y : start_y - cell_y) * delta_y;
+
+    int steps = std::abs(last_x - cell_x) + std::abs(last_y - cell_y);
+    for (int i = 0; i < steps; ++i) {
+        AddLogOdds(Cell(cell_x, cell_y), log_odds_miss);
+        if (next_x < next_y) {
+            next_x += delta_x;
+            cell_x += step_x;
+        } else {
+            next_y += delta_y;
+            cell_y += step_y;
+        }
+    }
+    AddLogOdds(Cell(cell_x, cell_y), hit ? log_odds_hit : log_odds_miss);
+}
+
+float OccupancyGrid::CellLogOdds(int cell_x, int cell_y) const {
+    const std::vector<float>* tile = FindTile(cell_x, cell_y);
+    if (tile == NULL) {
+        return 0;
+    }
+    return (*tile)[CellIndex(cell_x, cell_y)];
+}
+
+double OccupancyGrid::LogOdds(double x, double y) const {
+    return CellLogOdds(static_cast<int>(std::floor(x / resolution_)),
+                       static_cast<int>(std::floor(y / resolution_)));
+}
+
+int OccupancyGrid::State(double x, double y) const {
+    double log_odds = LogOdds(x, y);
+    if (log_odds > occupied_log_odds) {
+        return CELL_OCCUPIED;
+    }
+    if (log_odds < free_log_odds) {
+        return CELL_FREE;
+    }
+    return CELL_UNKNOWN;
+}
+
+int OccupancyGrid::UnknownAlong(double x, double y, double angle, double distance) const {
+    double step_x = std::cos(angle) * resolution_, step_y = std::sin(angle) * resolution_;
+    int steps = static_cast<int>(distance / resolution_);
+    int unknown = 0;
+    for (int i = 1; i <= steps; ++i) {
+        int state = State(x + i * step_x, y + i * step_y);
+        if (state == CELL_OCCUPIED) {
+            break;
+        }
+        if (state == CELL_UNKNOWN) {
+            ++unknown;
+        }
+    }
+    return unknown;
+}
+
+void OccupancyGrid::FindFrontiers(int min_size, std::vector<Frontier>& frontiers) const {
+    frontiers.clear();
+
+    // The free cells with an unknown neighbour. Neighbours inside the tile
+    // are read directly, only those across its border are looked up
+    std::unordered_set<long long> cells;
+    const int neighbour_x[4] = {1, -1, 0, 0};
+    const int neighbour_y[4] = {0, 0, 1, -1};
+    for (std::unordered_map<long long, int>::const_iterator it = tile_index_.begin();
+            it != tile_index_.end(); ++it) {
+        int tile_x = static_cast<int>(it->first >> 32);
+        int tile_y = static_cast<int>(it->first & 0xffffffffLL);
+        const std::vector<float>& tile = tiles_[it->second];
+        for (int y = 0; y < tile_size; ++y) {
+            for (int x = 0; x < tile_size; ++x) {
+                if (tile[(y << tile_bits) | x] >= free_log_odds) {
+                    continue;
+                }
+                bool frontier = false;
+                for (int n = 0; n < 4 && !frontier; ++n) {
+                    int next_x = x + neighbour_x[n], next_y = y + neighbour_y[n];
+                    float log_odds;
+                    if (next_x >= 0 && next_x < tile_size && next_y >= 0 && next_y < tile_size) {
+                        log_odds = tile[(next_y << tile_bits) | next_x];
+                    } else {
+                        log_odds = CellLogOdds((tile_x << tile_bits) + next_x,
+                                               (tile_y << tile_bits) + next_y);
+                    }
+                    frontier = IsUnknown(log_odds);
+                }
+                if (frontier) {
+                    cells.insert(TileKey((tile_x << tile_bits) + x, (tile_y << tile_bits) + y));
+                }
+            }
+        }
+    }
+
+    // Connected frontier cells, diagonals included, make one frontier. A
+    // frontier is kept within one tile, so a long border is split into
+    // pieces the robot can be sent to
+    std::vector<long long> piece;
+    while (!cells.empty()) {
+        piece.assign(1, *cells.begin());
+        cells.erase(cells.begin());
+        int tile_x = static_cast<int>(piece[0] >> 32) >> tile_bits;
+        int tile_y = static_cast<int>(piece[0] & 0xffffffffLL) >> tile_bits;
+        double sum_x = 0, sum_y = 0;
+        for (size_t i = 0; i < piece.size(); ++i) {
+            int cell_x = static_cast<int>(piece[i] >> 32);
+            int cell_y = static_cast<int>(piece[i] & 0xffffffffLL);
+            sum_x += cell_x;
+            sum_y += cell_y;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if ((cell_x + dx) >> tile_bits != tile_x
+                            || (cell_y + dy) >> tile_bits != tile_y) {
+                        continue;
+                    }
+                    std::unordered_set<long long>::iterator next =
+                        cells.find(TileKey(cell_x + dx, cell_y + dy));
+                    if (next != cells.end()) {
+                        piece.push_back(*next);
+                        cells.erase(next);
+                    }
+                }
+            }
+        }
+        int size = piece.size();
+        if (size < min_size) {
+            continue;
+        }
+
+        // The centre of a curved frontier may lie off it, so the robot is
+        // sent to the cell of the frontier closest to the centre
+        double centre_x = sum_x / size, centre_y = sum_y / size;
+        double best_distance = std::numeric_limits<double>::max();
+        Frontier result;
+        result.size_ = size;
+        for (int i = 0; i < size; ++i) {
+            int cell_x = static_cast<int>(piece[i] >> 32);
+            int cell_y = static_cast<int>(piece[i] & 0xffffffffLL);
+            double distance = (cell_x - centre_x) * (cell_x - centre_x)
+                              + (cell_y - centre_y) * (cell_y - centre_y);
+            if (distance < best_distance) {
+                best_distance = distance;
+                result.x_ = (cell_x + 0.5) * resolution_;
+                result.y_ = (cell_y + 0.5) * resolution_;
+            }
+        }
+        frontiers.push_back(result);
+    }
+}
+
+size_t OccupancyGrid::TileCount() const {
+    return tiles_.size();
+}
+
+double OccupancyGrid::Resolution() const {
+    return resolution_;
+}
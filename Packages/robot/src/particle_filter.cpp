@@ -0,0 +1,241 @@
+/**
+ * @file particle_filter.cpp
+ * @brief This file contains the implementation of the localisation of the
+ * robot in a known map.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "particle_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+// Noise of the odometry: standard deviation of the translation per metre
+// driven, of the rotation per radian turned and per metre driven, and a
+// little of both on every step to keep the particles apart
+const double translation_noise = 0.1;
+const double rotation_noise = 0.1;
+const double rotation_per_metre_noise = 0.05;
+const double translation_jitter = 0.005;
+const double rotation_jitter = 0.005;
+
+// The beams of a scan are not independent, so their summed log-likelihood
+// counts as much towards the weight as this many independent beams
+const double effective_beams = 10;
+
+// The particles are drawn anew once the effective number of particles falls
+// below this share of them
+const double resample_share = 0.5;
+
+// Bins of KLD sampling in metres and radians
+const double bin_size = 0.5;
+const double bin_angle = 10 * M_PI / 180;
+
+// KLD sampling keeps the error of the drawn distribution below kld_error with
+// the probability belonging to the standard normal quantile kld_quantile
+const double kld_error = 0.05;
+const double kld_quantile = 2.33;
+
+long long BinKey(const Pose2D& pose) {
+    long long x = static_cast<long long>(std::floor(pose.x_ / bin_size)) & 0xfffff;
+    long long y = static_cast<long long>(std::floor(pose.y_ / bin_size)) & 0xfffff;
+    long long theta = static_cast<long long>(std::floor(pose.theta_ / bin_angle)) & 0xfffff;
+    return (x << 40) | (y << 20) | theta;
+}
+
+// Particles needed for k occupied bins by the Wilson-Hilferty approximation
+// of the chi-square quantile
+double KldParticles(int bins) {
+    if (bins < 2) {
+        return 0;
+    }
+    double a = 2.0 / (9 * (bins - 1));
+    double b = 1 - a + std::sqrt(a) * kld_quantile;
+    return (bins - 1) / (2 * kld_error) * b * b * b;
+}
+
+}
+
+ParticleFilter::ParticleFilter() : min_particles_(200), max_particles_(20000), max_beams_(60),
+    laser_offset_(0), random_(42) {
+}
+
+void ParticleFilter::SetParams(int min_particles, int max_particles, int max_beams,
+                               double laser_offset) {
+    min_particles_ = min_particles;
+    max_particles_ = max_particles;
+    max_beams_ = max_beams;
+    laser_offset_ = laser_offset;
+}
+
+void ParticleFilter::SetMap(const std::vector<unsigned char>& occupied, int width, int height,
+                            double resolution, double origin_x, double origin_y,
+                            double hit_sigma) {
+    field_.SetMap(occupied, width, height, resolution, origin_x, origin_y, hit_sigma);
+}
+
+const LikelihoodField& ParticleFilter::Field() const {
+    return field_;
+}
+
+void ParticleFilter::InitialiseGlobal() {
+    particles_.clear();
+    weights_.clear();
+    const std::vector<int>& free_cells = field_.FreeCells();
+    if (free_cells.empty()) {
+        return;
+    }
+    std::uniform_int_distribution<int> cell(0, free_cells.size() - 1);
+    std::uniform_real_distribution<double> offset(-0.5, 0.5), heading(-M_PI, M_PI);
+    double resolution = field_.Resolution();
+    particles_.resize(max_particles_);
+    for (int i = 0; i < max_particles_; ++i) {
+        Pose2D& particle = particles_[i];
+        field_.CellCentre(free_cells[cell(random_)], particle.x_, particle.y_);
+        particle.x_ += offset(random_) * resolution;
+        particle.y_ += offset(random_) * resolution;
+        particle.theta_ = heading(random_);
+    }
+    weights_.assign(max_particles_, 1.0 / max_particles_);
+}
+
+void ParticleFilter::Predict(const Pose2D& motion) {
+    double translation = std::hypot(motion.x_, motion.y_);
+    std::normal_distribution<double> move(0, translation_noise * translation + translation_jitter);
+    std::normal_distribution<double> turn(0, rotation_noise * std::fabs(motion.theta_)
+                                          + rotation_per_metre_noise * translation
+                                          + rotation_jitter);
+    for (size_t i = 0; i < particles_.size(); ++i) {
+        Pose2D& particle = particles_[i];
+        double x = motion.x_ + move(random_), y = motion.y_ + move(random_);
+        double cos_theta = std::cos(particle.theta_), sin_theta = std::sin(particle.theta_);
+        particle.x_ += cos_theta * x - sin_theta * y;
+        particle.y_ += sin_theta * x + cos_theta * y;
+        particle.theta_ = NormaliseAngle(particle.theta_ + motion.theta_ + turn(random_));
+    }
+}
+
+void ParticleFilter::Correct(const std::vector<float>& ranges, double angle_min,
+                             double angle_increment, double range_max) {
+    if (particles_.empty() || !field_.HasMap() || max_beams_ <= 0) {
+        return;
+    }
+
+    // The used beam ends as seen from the centre of the robot
+    beam_x_.clear();
+    beam_y_.clear();
+    int size = ranges.size();
+    int stride = std::max(1, (size + max_beams_ - 1) / max_beams_);
+    for (int i = 0; i < size; i += stride) {
+        float range = ranges[i];
+        if (!(range > 0 && range < range_max)) {
+            continue;
+        }
+        double angle = angle_min + i * angle_increment;
+        beam_x_.push_back(static_cast<float>(laser_offset_ + range * std::cos(angle)));
+        beam_y_.push_back(static_cast<float>(range * std::sin(angle)));
+    }
+    int beams = beam_x_.size();
+    if (beams == 0) {
+        return;
+    }
+    end_x_.resize(beams);
+    end_y_.resize(beams);
+
+    // The log-likelihoods are kept in likelihoods_ until the best one is
+    // known, then they scale the weights the particles carry from earlier
+    // scans
+    likelihoods_.resize(particles_.size());
+    double best = -std::numeric_limits<double>::infinity();
+    for (size_t p = 0; p < particles_.size(); ++p) {
+        const Pose2D& particle = particles_[p];
+        float cos_theta = static_cast<float>(std::cos(particle.theta_));
+        float sin_theta = static_cast<float>(std::sin(particle.theta_));
+        float x = static_cast<float>(particle.x_), y = static_cast<float>(particle.y_);
+        for (int i = 0; i < beams; ++i) {
+            end_x_[i] = x + cos_theta * beam_x_[i] - sin_theta * beam_y_[i];
+            end_y_[i] = y + sin_theta * beam_x_[i] + cos_theta * beam_y_[i];
+        }
+        likelihoods_[p] = field_.SumLogLikelihood(&end_x_[0], &end_y_[0], beams);
+        best = std::max(best, likelihoods_[p]);
+    }
+    double share = std::min(1.0, effective_beams / beams);
+    double total = 0;
+    for (size_t p = 0; p < weights_.size(); ++p) {
+        weights_[p] *= std::exp((likelihoods_[p] - best) * share);
+        total += weights_[p];
+    }
+    double squares = 0;
+    for (size_t p = 0; p < weights_.size(); ++p) {
+        weights_[p] /= total;
+        squares += weights_[p] * weights_[p];
+    }
+
+    // Drawing anew loses particles, so it waits until only a few carry most
+    // of the weight
+    if (1 / squares < resample_share * particles_.size()) {
+        Resample();
+    }
+}
+
+void ParticleFilter::Resample() {
+    cumulative_.resize(weights_.size());
+    double sum = 0;
+    for (size_t p = 0; p < weights_.size(); ++p) {
+        sum += weights_[p];
+        cumulative_[p] = sum;
+    }
+
+    // Particles are drawn until there are enough for the bins they fill
+    std::uniform_real_distribution<double> draw(0, sum);
+    drawn_.clear();
+    bins_.clear();
+    double needed = std::max(1, min_particles_);
+    while (static_cast<int>(drawn_.size()) < std::min<double>(needed, max_particles_)) {
+        size_t index = std::lower_bound(cumulative_.begin(), cumulative_.end(), draw(random_))
+                       - cumulative_.begin();
+        index = std::min(index, particles_.size() - 1);
+        drawn_.push_back(particles_[index]);
+        if (bins_.insert(BinKey(drawn_.back())).second) {
+            needed = std::max<double>(needed, KldParticles(bins_.size()));
+        }
+    }
+    particles_.swap(drawn_);
+    weights_.assign(particles_.size(), 1.0 / particles_.size());
+}
+
+Pose2D ParticleFilter::Estimate() const {
+    Pose2D estimate = MakePose(0, 0, 0);
+    double sin_sum = 0, cos_sum = 0;
+    for (size_t p = 0; p < particles_.size(); ++p) {
+        estimate.x_ += weights_[p] * particles_[p].x_;
+        estimate.y_ += weights_[p] * particles_[p].y_;
+        sin_sum += weights_[p] * std::sin(particles_[p].theta_);
+        cos_sum += weights_[p] * std::cos(particles_[p].theta_);
+    }
+    estimate.theta_ = std::atan2(sin_sum, cos_sum);
+    return estimate;
+}
+
+double ParticleFilter::Spread() const {
+    Pose2D mean = Estimate();
+    double variance = 0;
+    for (size_t p = 0; p < particles_.size(); ++p) {
+        double dx = particles_[p].x_ - mean.x_, dy = particles_[p].y_ - mean.y_;
+        variance += weights_[p] * (dx * dx + dy * dy);
+    }
+    return std::sqrt(variance);
+}
+
+size_t ParticleFilter::ParticleCount() const {
+    return particles_.size();
+}
@@ -0,0 +1,320 @@
+/**
+ * @file path_planner.cpp
+ * @brief This file contains the implementation of the planning of a path to
+ * a goal through the map the robot builds.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "path_planner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "likelihood_field.h"
+
+namespace {
+
+// The window reaches this far in metres beyond the robot and the goal, so
+// the path can go around obstacles between them
+const double window_margin = 2.0;
+
+// The window never has more cells than this
+const int max_window_cells = 1000000;
+
+// Extra cost per metre of a cell right at the inflation radius, falling to
+// nothing at the caution distance beyond it
+const float caution_cost = 2.0f;
+
+// Cells this close in metres to the goal are never blocked, as the goal
+// itself may be an obstacle such as the circle
+const double goal_free_radius = 0.5;
+
+// Distance between two waypoints of a path in metres
+const double waypoint_spacing = 0.3;
+
+// Squared distance of a free cell before the distance transform
+const double no_obstacle = 1e12;
+
+// Keys are sums of many rounded step costs, so first components closer
+// than this in metres count as equal and the second one decides
+const float key_tolerance = 1e-4f;
+
+const float infinity = std::numeric_limits<float>::infinity();
+
+// Whether a cell with key a has to be looked at before one with key b
+bool KeyBefore(const std::pair<float, float>& a, const std::pair<float, float>& b) {
+    if (std::fabs(a.first - b.first) > key_tolerance) {
+        return a.first < b.first;
+    }
+    return a.second < b.second;
+}
+
+// The eight neighbours of a cell, straight ones first
+const int step_x[8] = {1, 0, -1, 0, 1, -1, -1, 1};
+const int step_y[8] = {0, 1, 0, -1, 1, 1, -1, -1};
+const float step_length[8] = {1, 1, 1, 1, 1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f};
+
+}
+
+PathPlanner::PathPlanner() : inflation_radius_(0.23), caution_distance_(0.25), goal_x_(0),
+    goal_y_(0), has_goal_(false), resolution_(0), window_x_(0), window_y_(0), width_(0),
+    height_(0), goal_cell_(-1), start_cell_(-1), key_modifier_(0) {
+}
+
+void PathPlanner::SetParams(double inflation_radius, double caution_distance) {
+    inflation_radius_ = inflation_radius;
+    caution_distance_ = caution_distance;
+    width_ = height_ = 0;
+}
+
+void PathPlanner::SetGoal(double x, double y) {
+    goal_x_ = x;
+    goal_y_ = y;
+    has_goal_ = true;
+    width_ = height_ = 0;
+}
+
+int PathPlanner::WindowCell(double x, double y) const {
+    int cell_x = static_cast<int>(std::floor(x / resolution_)) - window_x_;
+    int cell_y = static_cast<int>(std::floor(y / resolution_)) - window_y_;
+    if (cell_x < 1 || cell_y < 1 || cell_x >= width_ - 1 || cell_y >= height_ - 1) {
+        return -1;
+    }
+    return cell_y * width_ + cell_x;
+}
+
+void PathPlanner::ResetWindow(const OccupancyGrid& map, double start_x, double start_y) {
+    resolution_ = map.Resolution();
+    double min_x = std::min(start_x, goal_x_) - window_margin;
+    double min_y = std::min(start_y, goal_y_) - window_margin;
+    double max_x = std::max(start_x, goal_x_) + window_margin;
+    double max_y = std::max(start_y, goal_y_) + window_margin;
+    window_x_ = static_cast<int>(std::floor(min_x / resolution_));
+    window_y_ = static_cast<int>(std::floor(min_y / resolution_));
+    width_ = static_cast<int>(std::ceil(max_x / resolution_)) - window_x_ + 1;
+    height_ = static_cast<int>(std::ceil(max_y / resolution_)) - window_y_ + 1;
+    if (static_cast<double>(width_) * height_ > max_window_cells) {
+        width_ = height_ = 0;
+        return;
+    }
+
+    int cells = width_ * height_;
+    cost_.assign(cells, 0);
+    g_.assign(cells, infinity);
+    rhs_.assign(cells, infinity);
+    keys_.assign(cells, std::make_pair(infinity, infinity));
+    queued_.assign(cells, 0);
+    queue_.clear();
+    key_modifier_ = 0;
+    goal_cell_ = WindowCell(goal_x_, goal_y_);
+    start_cell_ = WindowCell(start_x, start_y);
+
+    // The search starts at the goal
+    rhs_[goal_cell_] = 0;
+    keys_[goal_cell_] = Key(goal_cell_);
+    queued_[goal_cell_] = 1;
+    queue_.insert(std::make_pair(keys_[goal_cell_], goal_cell_));
+}
+
+void PathPlanner::ComputeCosts(const OccupancyGrid& map, std::vector<float>& costs) {
+    int cells = width_ * height_;
+    squared_.resize(cells);
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            int state = map.State((window_x_ + x + 0.5) * resolution_,
+                                  (window_y_ + y + 0.5) * resolution_);
+            squared_[y * width_ + x] = state == CELL_OCCUPIED ? 0 : no_obstacle;
+        }
+    }
+    SquaredDistanceTransform(squared_, width_, height_);
+
+    costs.resize(cells);
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            int cell = y * width_ + x;
+            double distance = std::sqrt(squared_[cell]) * resolution_;
+            float cost = 0;
+            if (distance < inflation_radius_) {
+                cost = infinity;
+            } else if (distance < inflation_radius_ + caution_distance_) {
+                cost = caution_cost
+                       * static_cast<float>(1 - (distance - inflation_radius_) / caution_distance_);
+            }
+            double goal_distance = std::hypot((window_x_ + x + 0.5) * resolution_ - goal_x_,
+                                              (window_y_ + y + 0.5) * resolution_ - goal_y_);
+            if (goal_distance < goal_free_radius) {
+                cost = std::min(cost, caution_cost);
+            }
+            costs[cell] = cost;
+        }
+    }
+}
+
+int PathPlanner::Neighbour(int cell, int direction) const {
+    int x = cell % width_ + step_x[direction], y = cell / width_ + step_y[direction];
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+        return -1;
+    }
+    return y * width_ + x;
+}
+
+float PathPlanner::StepCost(int cell, int direction) const {
+    int next = Neighbour(cell, direction);
+    if (next < 0) {
+        return infinity;
+    }
+    // Only the cell driven into counts, so a robot already too close to an
+    // obstacle can still get away from it
+    return step_length[direction] * static_cast<float>(resolution_) * (1 + cost_[next]);
+}
+
+float PathPlanner::Heuristic(int from, int to) const {
+    int dx = std::abs(from % width_ - to % width_), dy = std::abs(from / width_ - to / width_);
+    int straight = std::abs(dx - dy), diagonal = std::min(dx, dy);
+    return static_cast<float>((straight + 1.41421356 * diagonal) * resolution_);
+}
+
+std::pair<float, float> PathPlanner::Key(int cell) const {
+    float best = std::min(g_[cell], rhs_[cell]);
+    return std::make_pair(best + Heuristic(start_cell_, cell) + key_modifier_, best);
+}
+
+void PathPlanner::UpdateCell(int cell) {
+    if (cell != goal_cell_) {
+        float best = infinity;
+        for (int d = 0; d < 8; ++d) {
+            int next = Neighbour(cell, d);
+            if (next >= 0) {
+                best = std::min(best, StepCost(cell, d) + g_[next]);
+            }
+        }
+        rhs_[cell] = best;
+    }
+    if (queued_[cell]) {
+        queue_.erase(std::make_pair(keys_[cell], cell));
+        queued_[cell] = 0;
+    }
+    if (g_[cell] != rhs_[cell]) {
+        keys_[cell] = Key(cell);
+        queue_.insert(std::make_pair(keys_[cell], cell));
+        queued_[cell] = 1;
+    }
+}
+
+void PathPlanner::ComputeShortestPath() {
+    while (!queue_.empty()
+            && (KeyBefore(queue_.begin()->first, Key(start_cell_)) || rhs_[start_cell_] != g_[start_cell_])) {
+        int cell = queue_.begin()->second;
+        std::pair<float, float> old_key = queue_.begin()->first;
+        std::pair<float, float> new_key = Key(cell);
+        if (old_key < new_key) {
+            // The robot has moved since the cell was queued
+            queue_.erase(queue_.begin());
+            keys_[cell] = new_key;
+            queue_.insert(std::make_pair(new_key, cell));
+        } else if (g_[cell] > rhs_[cell]) {
+            g_[cell] = rhs_[cell];
+            queue_.erase(queue_.begin());
+            queued_[cell] = 0;
+            for (int d = 0; d < 8; ++d) {
+                int next = Neighbour(cell, d);
+                if (next >= 0) {
+                    UpdateCell(next);
+                }
+            }
+        } else {
+            g_[cell] = infinity;
+            UpdateCell(cell);
+            for (int d = 0; d < 8; ++d) {
+                int next = Neighbour(cell, d);
+                if (next >= 0) {
+                    UpdateCell(next);
+                }
+            }
+        }
+    }
+}
+
+bool PathPlanner::Plan(const OccupancyGrid& map, double start_x, double start_y,
+                       std::vector<double>& path_x, std::vector<double>& path_y) {
+    path_x.clear();
+    path_y.clear();
+    if (!has_goal_) {
+        return false;
+    }
+
+    // A new window when the robot leaves the old one, else only the cells
+    // whose cost changed are updated
+    bool fresh = width_ == 0 || resolution_ != map.Resolution()
+                 || WindowCell(start_x, start_y) < 0;
+    if (fresh) {
+        ResetWindow(map, start_x, start_y);
+        if (width_ == 0) {
+            return false;
+        }
+    }
+    ComputeCosts(map, new_cost_);
+    int start = WindowCell(start_x, start_y);
+    key_modifier_ += Heuristic(start_cell_, start);
+    start_cell_ = start;
+    if (fresh) {
+        cost_.swap(new_cost_);
+    }
+    for (size_t cell = 0; !fresh && cell < new_cost_.size(); ++cell) {
+        if (new_cost_[cell] == cost_[cell]) {
+            continue;
+        }
+        cost_[cell] = new_cost_[cell];
+        for (int d = 0; d < 8; ++d) {
+            int next = Neighbour(cell, d);
+            if (next >= 0) {
+                UpdateCell(next);
+            }
+        }
+    }
+    ComputeShortestPath();
+    if (g_[start_cell_] == infinity) {
+        return false;
+    }
+
+    // Downhill from the robot to the goal
+    int cell = start_cell_;
+    double travelled = 0;
+    for (int steps = 0; cell != goal_cell_ && steps < width_ * height_; ++steps) {
+        int best_direction = -1;
+        float best = infinity;
+        for (int d = 0; d < 8; ++d) {
+            int next = Neighbour(cell, d);
+            if (next >= 0 && StepCost(cell, d) + g_[next] < best) {
+                best = StepCost(cell, d) + g_[next];
+                best_direction = d;
+            }
+        }
+        if (best_direction < 0) {
+            path_x.clear();
+            path_y.clear();
+            return false;
+        }
+        cell = Neighbour(cell, best_direction);
+        travelled += step_length[best_direction] * resolution_;
+        if (travelled >= waypoint_spacing) {
+            path_x.push_back((window_x_ + cell % width_ + 0.5) * resolution_);
+            path_y.push_back((window_y_ + cell / width_ + 0.5) * resolution_);
+            travelled = 0;
+        }
+    }
+    if (cell != goal_cell_) {
+        path_x.clear();
+        path_y.clear();
+        return false;
+    }
+    path_x.push_back(goal_x_);
+    path_y.push_back(goal_y_);
+    return true;
+}
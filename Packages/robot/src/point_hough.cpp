@@ -0,0 +1,338 @@
+/**
+ * @file point_hough.cpp
+ * @brief This file contains the implementation of the sparse point-voting
+ * Hough transform.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "point_hough.h"
+#include "detect_helpers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <opencv2/core/core.hpp>
+#include <vector>
+
+namespace {
+
+// Number of neighbours on each side used to estimate the normal of a point
+const int normal_neighbours = 3;
+
+// Half width of the voting window around the normal, in degrees. Wide enough
+// to absorb the noise of the normal estimate, narrow enough that walls do not
+// gather many votes in a single cell
+const int normal_window = 15;
+
+// Points close to a straight wall also pile up votes behind it, but only over
+// a narrow arc. A circle has to be supported over at least this many 10 degree
+// sectors of its ring
+const int min_arc_sectors = 9;
+
+// Distance from the ring, in pixels, at which a point still supports a circle
+const float ring_tolerance = 1.0;
+
+/**
+ * @brief Candidate circle found for a single radius
+ */
+struct VoteCandidate {
+    float x_;
+    float y_;
+    float radius_;
+    int votes_;
+};
+
+bool CompareVotes(const VoteCandidate& a, const VoteCandidate& b) {
+    return a.votes_ > b.votes_;
+}
+
+/**
+ * @brief Checks that the points supporting a circle are spread over an arc
+ * and not bunched up in one spot
+ */
+bool CoversArc(const std::vector<cv::Point2f>& points, const VoteCandidate& candidate) {
+    bool sectors[36] = {false};
+    int covered = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        float dx = points[i].x - candidate.x_, dy = points[i].y - candidate.y_;
+        if (std::fabs(std::sqrt(dx * dx + dy * dy) - candidate.radius_) <= ring_tolerance) {
+            int sector = static_cast<int>(cv::fastAtan2(dy, dx) / 10) % 36;
+            if (!sectors[sector]) {
+                sectors[sector] = true;
+                if (++covered >= min_arc_sectors) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool CompareAngles(const std::pair<float, cv::Point>& a, const std::pair<float, cv::Point>& b) {
+    return a.first < b.first;
+}
+
+}
+
+/**
+ * @brief Votes for all radii in a range. Every invocation owns its
+ * accumulator, so radii can be processed in parallel without locking. Radii
+ * that are reached after the deadline are left out and marked as not done.
+ */
+class PointHough::VoteBody : public cv::ParallelLoopBody {
+public:
+    VoteBody(const std::vector<RadiusOffsets>& rings,
+             const std::vector<cv::Point>& cells,
+             const std::vector<int>& normal_angles, const cv::Rect& box,
+             int threshold, const Deadline& deadline,
+             std::vector<std::vector<VoteCandidate> >& results, std::vector<uchar>& done)
+        : rings_(rings), cells_(cells), normal_angles_(normal_angles), box_(box),
+          threshold_(threshold), deadline_(deadline), results_(results), done_(done) {
+    }
+
+    void operator()(const cv::Range& range) const {
+        std::vector<ushort> accumulator(box_.width * box_.height);
+
+        for (int r = range.start; r < range.end; ++r) {
+            if (deadline_.Expired()) {
+                return;
+            }
+            done_[r] = 1;
+            std::fill(accumulator.begin(), accumulator.end(), 0);
+            std::vector<int> peaks;
+            Vote(r, accumulator, peaks);
+            ExtractPeaks(r, accumulator, peaks);
+        }
+    }
+
+private:
+    const std::vector<RadiusOffsets>& rings_;
+    const std::vector<cv::Point>& cells_;
+    const std::vector<int>& normal_angles_;
+    const cv::Rect& box_;
+    int threshold_;
+    const Deadline& deadline_;
+    std::vector<std::vector<VoteCandidate> >& results_;
+    std::vector<uchar>& done_;
+
+    void VoteRange(int cell, int first, int last, const std::vector<cv::Point>& offsets,
+                   std::vector<ushort>& accumulator, std::vector<int>& peaks) const {
+        for (int j = first; j < last; ++j) {
+            int index = cell + offsets[j].y * box_.width + offsets[j].x;
+            if (++accumulator[index] == threshold_) {
+                peaks.push_back(index);
+            }
+        }
+    }
+
+    void Vote(int r, std::vector<ushort>& accumulator, std::vector<int>& peaks) const {
+        const std::vector<cv::Point>& offsets = rings_[r].offsets_;
+        const std::vector<int>& angles = rings_[r].angle_start_;
+
+        for (size_t i = 0; i < cells_.size(); ++i) {
+            if (normal_angles_[i] < 0) {
+                continue;
+            }
+            int cell = (cells_[i].y - box_.y) * box_.width + (cells_[i].x - box_.x);
+            int low = normal_angles_[i] - normal_window;
+            int high = normal_angles_[i] + normal_window + 1;
+
+            // The window may wrap around 0 degrees
+            if (low < 0) {
+                VoteRange(cell, angles[low + 360], angles[360], offsets, accumulator, peaks);
+                VoteRange(cell, angles[0], angles[high], offsets, accumulator, peaks);
+            } else if (high > 360) {
+                VoteRange(cell, angles[low], angles[360], offsets, accumulator, peaks);
+                VoteRange(cell, angles[0], angles[high - 360], offsets, accumulator, peaks);
+            } else {
+                VoteRange(cell, angles[low], angles[high], offsets, accumulator, peaks);
+            }
+        }
+    }
+
+    void ExtractPeaks(int r, const std::vector<ushort>& accumulator,
+                      const std::vector<int>& peaks) const {
+        int width = box_.width;
+        for (size_t i = 0; i < peaks.size(); ++i) {
+            int index = peaks[i];
+            int x = index % width, y = index / width;
+            // Peaks on the border cannot be centres since every ring fits the box
+            if (x == 0 || y == 0 || x == width - 1 || y == box_.height - 1) {
+                continue;
+            }
+
+            // Keep local maxima only; ties go to the first cell in memory order
+            int value = accumulator[index];
+            bool is_max = true;
+            float sum = 0, sum_x = 0, sum_y = 0;
+            for (int dy = -1; dy <= 1 && is_max; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int neighbour = index + dy * width + dx;
+                    int votes = accumulator[neighbour];
+                    if (votes > value || (votes == value && neighbour < index)) {
+                        is_max = false;
+                        break;
+                    }
+                    sum += votes;
+                    sum_x += votes * dx;
+                    sum_y += votes * dy;
+                }
+            }
+
+            if (is_max) {
+                // Weighted centroid of the 3x3 neighbourhood gives a sub-cell centre
+                VoteCandidate candidate;
+                candidate.x_ = box_.x + x + sum_x / sum;
+                candidate.y_ = box_.y + y + sum_y / sum;
+                candidate.radius_ = static_cast<float>(rings_[r].radius_);
+                candidate.votes_ = value;
+                results_[r].push_back(candidate);
+            }
+        }
+    }
+};
+
+PointHough::PointHough() : min_radius_(-1), max_radius_(-1) {
+}
+
+void PointHough::PrecomputeOffsets(int min_radius, int max_radius) {
+    if (min_radius == min_radius_ && max_radius == max_radius_) {
+        return;
+    }
+    min_radius_ = min_radius;
+    max_radius_ = max_radius;
+    rings_.clear();
+
+    for (int radius = min_radius; radius <= max_radius; ++radius) {
+        RadiusOffsets ring;
+        ring.radius_ = radius;
+
+        // Cells whose rounded distance is the radius, so consecutive radii
+        // partition the plane and no cell is voted twice for one point
+        std::vector<std::pair<float, cv::Point> > cells;
+        for (int dy = -radius - 1; dy <= radius + 1; ++dy) {
+            for (int dx = -radius - 1; dx <= radius + 1; ++dx) {
+                if (cvRound(std::sqrt(static_cast<float>(dx * dx + dy * dy))) == radius) {
+                    float angle = cv::fastAtan2(static_cast<float>(dy), static_cast<float>(dx));
+                    cells.push_back(std::make_pair(angle, cv::Point(dx, dy)));
+                }
+            }
+        }
+        std::sort(cells.begin(), cells.end(), CompareAngles);
+
+        ring.angle_start_.resize(361);
+        size_t index = 0;
+        for (int degree = 0; degree <= 360; ++degree) {
+            while (index < cells.size() && cells[index].first < degree) {
+                ++index;
+            }
+            ring.angle_start_[degree] = static_cast<int>(index);
+        }
+        for (size_t i = 0; i < cells.size(); ++i) {
+            ring.offsets_.push_back(cells[i].second);
+        }
+
+        rings_.push_back(ring);
+    }
+}
+
+void PointHough::EstimateNormals(const std::vector<cv::Point2f>& points,
+                                 const cv::Point2f& origin, float max_gap,
+                                 std::vector<int>& normal_angles) {
+    int size = static_cast<int>(points.size());
+    normal_angles.assign(size, -1);
+
+    // Split the points into segments at range discontinuities
+    std::vector<int> segment_start(size), segment_end(size);
+    int start = 0;
+    for (int i = 1; i <= size; ++i) {
+        if (i == size || std::hypot(points[i].x - points[i - 1].x,
+                                    points[i].y - points[i - 1].y) > max_gap) {
+            for (int j = start; j < i; ++j) {
+                segment_start[j] = start;
+                segment_end[j] = i - 1;
+            }
+            start = i;
+        }
+    }
+
+    for (int i = 0; i < size; ++i) {
+        int first = std::max(i - normal_neighbours, segment_start[i]);
+        int last = std::min(i + normal_neighbours, segment_end[i]);
+        if (last - first < 2) {
+            continue;
+        }
+
+        float normal_x = -(points[last].y - points[first].y);
+        float normal_y = points[last].x - points[first].x;
+        // The centre of a visible circle is always further away than its surface
+        if (normal_x * (points[i].x - origin.x) + normal_y * (points[i].y - origin.y) < 0) {
+            normal_x = -normal_x;
+            normal_y = -normal_y;
+        }
+        normal_angles[i] = cvRound(cv::fastAtan2(normal_y, normal_x)) % 360;
+    }
+}
+
+bool PointHough::Detect(const std::vector<cv::Point2f>& points, const cv::Point2f& origin,
+                        const HoughParams& params, std::vector<cv::Vec3f>& circles,
+                        const Deadline& deadline) {
+    circles.clear();
+    if (points.empty() || params.max_radius_ < params.min_radius_) {
+        return true;
+    }
+
+    PrecomputeOffsets(std::max(params.min_radius_, 1), params.max_radius_);
+
+    std::vector<int> normal_angles;
+    EstimateNormals(points, origin, std::max(3.0f, min_radius_ / 2.0f), normal_angles);
+
+    // The accumulator only spans the points grown by the largest ring
+    std::vector<cv::Point> cells(points.size());
+    int min_x = cvRound(points[0].x), max_x = min_x;
+    int min_y = cvRound(points[0].y), max_y = min_y;
+    for (size_t i = 0; i < points.size(); ++i) {
+        cells[i] = cv::Point(cvRound(points[i].x), cvRound(points[i].y));
+        min_x = std::min(min_x, cells[i].x);
+        max_x = std::max(max_x, cells[i].x);
+        min_y = std::min(min_y, cells[i].y);
+        max_y = std::max(max_y, cells[i].y);
+    }
+    int margin = max_radius_ + 2;
+    cv::Rect box(min_x - margin, min_y - margin,
+                 max_x - min_x + 2 * margin + 1, max_y - min_y + 2 * margin + 1);
+
+    std::vector<std::vector<VoteCandidate> > results(rings_.size());
+    std::vector<uchar> done(rings_.size(), 0);
+    VoteBody body(rings_, cells, normal_angles, box, std::max(params.threshold_2_, 1),
+                  deadline, results, done);
+    cv::parallel_for_(cv::Range(0, static_cast<int>(rings_.size())), body);
+
+    std::vector<VoteCandidate> candidates;
+    for (size_t i = 0; i < results.size(); ++i) {
+        for (size_t j = 0; j < results[i].size(); ++j) {
+            candidates.push_back(results[i][j]);
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), CompareVotes);
+
+    // Non maximum suppression with the same semantics as cv::HoughCircles
+    float min_dist_2 = static_cast<float>(params.min_dist_) * params.min_dist_;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        bool keep = true;
+        for (size_t j = 0; j < circles.size() && keep; ++j) {
+            float dx = candidates[i].x_ - circles[j][0];
+            float dy = candidates[i].y_ - circles[j][1];
+            keep = dx * dx + dy * dy >= min_dist_2;
+        }
+        if (keep && CoversArc(points, candidates[i])) {
+            circles.push_back(cv::Vec3f(candidates[i].x_, candidates[i].y_, candidates[i].radius_));
+        }
+    }
+
+    return std::find(done.begin(), done.end(), 0) == done.end();
+}
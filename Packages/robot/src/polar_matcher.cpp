@@ -0,0 +1,240 @@
+/**
+ * @file polar_matcher.cpp
+ * @brief This file contains the implementation of the circle detector that
+ * matches range profile templates in polar space.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "polar_matcher.h"
+#include "circle_fit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Spacing of the template radii and distances in metres
+const double radius_step = 0.01;
+const double distance_step = 0.02;
+
+// Only the middle of the dip is compared, the flanks are too steep to
+// compare beam by beam
+const double template_part = 0.7;
+
+// Number of Gauss-Newton iterations of the confirming fit
+const int fit_iterations = 5;
+
+bool CompareResiduals(const PolarMatch& a, const PolarMatch& b) {
+    return a.residual_ < b.residual_;
+}
+
+}
+
+PolarMatcher::PolarMatcher() : angle_increment_(0), min_radius_(0), max_radius_(0),
+    max_range_(0) {
+}
+
+void PolarMatcher::PrecomputeTemplates(double angle_increment, double min_radius,
+                                       double max_radius, double max_range) {
+    if (!templates_.empty() && angle_increment == angle_increment_) {
+        if (min_radius >= min_radius_ - 1e-9 && max_radius <= max_radius_ + 1e-9
+                && max_range <= max_range_) {
+            return;
+        }
+        min_radius = std::min(min_radius, min_radius_);
+        max_radius = std::max(max_radius, max_radius_);
+        max_range = std::max(max_range, max_range_);
+    }
+    angle_increment_ = angle_increment;
+    min_radius_ = min_radius;
+    max_radius_ = max_radius;
+    max_range_ = max_range;
+
+    radii_.clear();
+    for (int r = 0; min_radius + r * radius_step <= max_radius + 1e-9; ++r) {
+        radii_.push_back(static_cast<float>(min_radius + r * radius_step));
+    }
+
+    int bins = static_cast<int>((max_range + max_radius) / distance_step) + 2;
+    templates_.assign(radii_.size(), std::vector<Template>(bins));
+    for (size_t r = 0; r < radii_.size(); ++r) {
+        double radius = radii_[r];
+        for (int bin = 0; bin < bins; ++bin) {
+            Template& circle_template = templates_[r][bin];
+            double distance = bin * distance_step;
+            circle_template.half_width_ = 0;
+            // The laser is inside the circle
+            if (distance <= radius) {
+                continue;
+            }
+
+            double half_angle = template_part * std::asin(radius / distance);
+            int half_width = static_cast<int>(half_angle / angle_increment);
+            if (half_width < 2) {
+                continue;
+            }
+
+            circle_template.half_width_ = half_width;
+            circle_template.profile_.resize(2 * half_width + 1);
+            for (int k = -half_width; k <= half_width; ++k) {
+                double angle = k * angle_increment;
+                double sine = distance * std::sin(angle);
+                circle_template.profile_[k + half_width] = static_cast<float>(
+                    distance * std::cos(angle) - std::sqrt(radius * radius - sine * sine)
+                    - (distance - radius));
+            }
+        }
+    }
+}
+
+float PolarMatcher::Compare(const std::vector<float>& ranges, int index,
+                            const Template& circle_template) {
+    int half_width = circle_template.half_width_;
+    if (half_width == 0 || index - half_width < 0
+            || index + half_width >= static_cast<int>(ranges.size())) {
+        return -1;
+    }
+
+    // Four independent sums so the loop maps onto vector registers
+    const float* window = &ranges[index - half_width];
+    const float* profile = &circle_template.profile_[0];
+    float base = ranges[index];
+    int length = 2 * half_width + 1;
+    float sum[4] = {0, 0, 0, 0};
+    int k = 0;
+    for (; k + 4 <= length; k += 4) {
+        for (int lane = 0; lane < 4; ++lane) {
+            float error = window[k + lane] - base - profile[k + lane];
+            sum[lane] += error * error;
+        }
+    }
+    for (; k < length; ++k) {
+        float error = window[k] - base - profile[k];
+        sum[0] += error * error;
+    }
+
+    return std::sqrt((sum[0] + sum[1] + sum[2] + sum[3]) / length);
+}
+
+bool PolarMatcher::Match(const std::vector<float>& ranges, double angle_increment,
+                         double min_radius, double max_radius, double max_range,
+                         double max_error, std::vector<PolarMatch>& matches,
+                         const Deadline& deadline) {
+    matches.clear();
+    if (ranges.size() < 5 || angle_increment <= 0 || max_radius < min_radius) {
+        return true;
+    }
+    PrecomputeTemplates(angle_increment, min_radius, max_radius, max_range);
+
+    // The templates of the radii asked for, at least the closest one
+    int first_radius = static_cast<int>(std::ceil((min_radius - min_radius_) / radius_step - 1e-6));
+    int last_radius = static_cast<int>(std::floor((max_radius - min_radius_) / radius_step + 1e-6));
+    if (first_radius > last_radius) {
+        first_radius = last_radius = static_cast<int>(
+            (0.5 * (min_radius + max_radius) - min_radius_) / radius_step + 0.5);
+    }
+    first_radius = std::max(first_radius, 0);
+    last_radius = std::min(last_radius, static_cast<int>(radii_.size()) - 1);
+
+    int size = static_cast<int>(ranges.size());
+    int bins = static_cast<int>(templates_.front().size());
+    bool complete = true;
+    for (int i = 2; i < size - 2; ++i) {
+        float range = ranges[i];
+        // The beam towards the centre hits the closest point of the circle
+        if (!(range < max_range) || range > ranges[i - 1] || range > ranges[i + 1]
+                || range > ranges[i - 2] || range > ranges[i + 2]) {
+            continue;
+        }
+        // Only minima cost time, so the clock is read there
+        if (deadline.Expired()) {
+            complete = false;
+            break;
+        }
+
+        int best = -1;
+        float best_error = static_cast<float>(max_error);
+        for (int r = first_radius; r <= last_radius; ++r) {
+            int bin = static_cast<int>((range + radii_[r]) / distance_step + 0.5);
+            if (bin >= bins) {
+                continue;
+            }
+            float error = Compare(ranges, i, templates_[r][bin]);
+            if (error >= 0 && error <= best_error) {
+                best_error = error;
+                best = r;
+            }
+        }
+        if (best < 0) {
+            continue;
+        }
+
+        // Confirm with a fit of the beams under the whole visible half, in a
+        // frame where beam i points along x
+        float radius = radii_[best];
+        float distance = range + radius;
+        int half_width = static_cast<int>(0.9 * std::asin(radius / distance) / angle_increment);
+        std::vector<cv::Point2f> points;
+        for (int k = std::max(0, i - half_width); k <= std::min(size - 1, i + half_width); ++k) {
+            double angle = (k - i) * angle_increment;
+            points.push_back(cv::Point2f(ranges[k] * std::cos(angle), ranges[k] * std::sin(angle)));
+        }
+        std::vector<cv::Point2f> selected;
+        SelectCirclePoints(points, cv::Point2f(distance, 0), radius, 3 * max_error, selected);
+
+        CircleFit fit;
+        fit.centre_ = cv::Point2f(distance, 0);
+        fit.radius_ = radius;
+        if (!FitCircleGeometric(selected, fit, fit_iterations) || fit.residual_ > max_error
+                || fit.radius_ < 0.8 * min_radius || fit.radius_ > 1.2 * max_radius) {
+            continue;
+        }
+
+        // Walls fit large circles over short arcs as well. The beams just
+        // past the edges of a circle miss it, so they have to reach further
+        // than the tangent points
+        double centre_2 = fit.centre_.x * fit.centre_.x + fit.centre_.y * fit.centre_.y;
+        double tangent = std::sqrt(std::max(0.0, centre_2 - fit.radius_ * fit.radius_));
+        double centre_index = i + std::atan2(fit.centre_.y, fit.centre_.x) / angle_increment;
+        double edge = std::asin(std::min(1.0, fit.radius_ / std::sqrt(centre_2))) / angle_increment;
+        int left = static_cast<int>(std::floor(centre_index - edge)) - 2;
+        int right = static_cast<int>(std::ceil(centre_index + edge)) + 2;
+        if (left < 0 || right >= size || !(ranges[left] > tangent + 3 * max_error)
+                || !(ranges[right] > tangent + 3 * max_error)) {
+            continue;
+        }
+
+        PolarMatch match;
+        match.index_ = i + std::atan2(fit.centre_.y, fit.centre_.x) / angle_increment;
+        match.distance_ = std::sqrt(fit.centre_.x * fit.centre_.x + fit.centre_.y * fit.centre_.y);
+        match.radius_ = fit.radius_;
+        match.residual_ = fit.residual_;
+        matches.push_back(match);
+    }
+
+    // Keep the best of overlapping matches
+    std::sort(matches.begin(), matches.end(), CompareResiduals);
+    std::vector<PolarMatch> kept;
+    for (size_t i = 0; i < matches.size(); ++i) {
+        bool overlaps = false;
+        for (size_t j = 0; j < kept.size() && !overlaps; ++j) {
+            double angle = (matches[i].index_ - kept[j].index_) * angle_increment;
+            double gap_2 = matches[i].distance_ * matches[i].distance_
+                           + kept[j].distance_ * kept[j].distance_
+                           - 2 * matches[i].distance_ * kept[j].distance_ * std::cos(angle);
+            double reach = matches[i].radius_ + kept[j].radius_;
+            overlaps = gap_2 < reach * reach;
+        }
+        if (!overlaps) {
+            kept.push_back(matches[i]);
+        }
+    }
+    matches.swap(kept);
+    return complete;
+}
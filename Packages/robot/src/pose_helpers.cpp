@@ -0,0 +1,107 @@
+/**
+ * @file pose_helpers.cpp
+ * @brief Defines the helpers to work with planar robot poses from odometry
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "pose_helpers.h"
+#include <cmath>
+
+Pose2D MakePose(double x, double y, double theta) {
+    Pose2D pose;
+    pose.x_ = x;
+    pose.y_ = y;
+    pose.theta_ = theta;
+    return pose;
+}
+
+double NormaliseAngle(double angle) {
+    angle = std::fmod(angle + M_PI, 2 * M_PI);
+    if (angle < 0) {
+        angle += 2 * M_PI;
+    }
+    return angle - M_PI;
+}
+
+double YawFromQuaternion(double x, double y, double z, double w) {
+    return std::atan2(2 * (w * z + x * y), 1 - 2 * (y * y + z * z));
+}
+
+Pose2D RelativePose(const Pose2D& from, const Pose2D& to) {
+    double dx = to.x_ - from.x_, dy = to.y_ - from.y_;
+    double cos_theta = std::cos(from.theta_), sin_theta = std::sin(from.theta_);
+
+    Pose2D motion;
+    motion.x_ = cos_theta * dx + sin_theta * dy;
+    motion.y_ = -sin_theta * dx + cos_theta * dy;
+    motion.theta_ = NormaliseAngle(to.theta_ - from.theta_);
+    return motion;
+}
+
+Pose2D ComposePose(const Pose2D& from, const Pose2D& motion) {
+    double cos_theta = std::cos(from.theta_), sin_theta = std::sin(from.theta_);
+
+    Pose2D pose;
+    pose.x_ = from.x_ + cos_theta * motion.x_ - sin_theta * motion.y_;
+    pose.y_ = from.y_ + sin_theta * motion.x_ + cos_theta * motion.y_;
+    pose.theta_ = NormaliseAngle(from.theta_ + motion.theta_);
+    return pose;
+}
+
+Pose2D LaserMotion(const Pose2D& motion, double laser_offset) {
+    Pose2D laser_motion = motion;
+    laser_motion.x_ += laser_offset * (std::cos(motion.theta_) - 1);
+    laser_motion.y_ += laser_offset * std::sin(motion.theta_);
+    return laser_motion;
+}
+
+void TransformToMovedFrame(const Pose2D& motion, double& x, double& y) {
+    double dx = x - motion.x_, dy = y - motion.y_;
+    double cos_theta = std::cos(motion.theta_), sin_theta = std::sin(motion.theta_);
+    x = cos_theta * dx + sin_theta * dy;
+    y = -sin_theta * dx + cos_theta * dy;
+}
+
+PoseHistory::PoseHistory(double span) : span_(span) {
+}
+
+void PoseHistory::Add(double stamp, const Pose2D& pose) {
+    if (!stamps_.empty() && stamp < stamps_.back()) {
+        stamps_.clear();
+        poses_.clear();
+    }
+    stamps_.push_back(stamp);
+    poses_.push_back(pose);
+    while (stamps_.front() < stamp - span_) {
+        stamps_.pop_front();
+        poses_.pop_front();
+    }
+}
+
+bool PoseHistory::PoseAt(double stamp, Pose2D& pose) const {
+    if (stamps_.empty() || stamp < stamps_.front()) {
+        return false;
+    }
+    if (stamp >= stamps_.back()) {
+        pose = poses_.back();
+        return true;
+    }
+
+    // The first pose after the time, the one before it is at or before it
+    size_t after = 1;
+    while (stamps_[after] <= stamp) {
+        ++after;
+    }
+    const Pose2D& from = poses_[after - 1];
+    const Pose2D& to = poses_[after];
+    double share = (stamp - stamps_[after - 1]) / (stamps_[after] - stamps_[after - 1]);
+    pose.x_ = from.x_ + share * (to.x_ - from.x_);
+    pose.y_ = from.y_ + share * (to.y_ - from.y_);
+    pose.theta_ = NormaliseAngle(from.theta_ + share * NormaliseAngle(to.theta_ - from.theta_));
+    return true;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file scan_deskew.cpp
+ * @brief This file contains the implementation of the correction of the
+ * motion of the robot during a laser sweep.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "scan_deskew.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Below these velocities the robot is taken to stand still
+const double min_linear_velocity = 1e-3;
+const double min_angular_velocity = 1e-3;
+
+// Two neighbouring beams are on the same surface if their ranges differ by
+// less than this share
+const double max_gap_share = 0.05;
+
+}
+
+ScanDeskewer::ScanDeskewer() : angle_min_(0), angle_increment_(0), laser_offset_(0) {
+}
+
+void ScanDeskewer::SetParams(double laser_offset) {
+    laser_offset_ = laser_offset;
+}
+
+void ScanDeskewer::PrecomputeAngles(float angle_min, float angle_increment, size_t size) {
+    if (cos_.size() == size && angle_min == angle_min_ && angle_increment == angle_increment_) {
+        return;
+    }
+    angle_min_ = angle_min;
+    angle_increment_ = angle_increment;
+    cos_.resize(size);
+    sin_.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        double angle = angle_min + i * angle_increment;
+        cos_[i] = static_cast<float>(std::cos(angle));
+        sin_[i] = static_cast<float>(std::sin(angle));
+    }
+}
+
+bool ScanDeskewer::Deskew(const sensor_msgs::LaserScan& scan, double linear_velocity,
+                          double angular_velocity, std::vector<float>& ranges) {
+    ranges.assign(scan.ranges.begin(), scan.ranges.end());
+    size_t size = ranges.size();
+
+    // Time between two beams
+    double beam_time = scan.time_increment;
+    if (beam_time <= 0) {
+        beam_time = scan.scan_time * std::fabs(scan.angle_increment) / (2 * M_PI);
+    }
+    if (size < 2 || beam_time <= 0 || scan.angle_increment == 0
+            || (std::fabs(linear_velocity) < min_linear_velocity
+                && std::fabs(angular_velocity) < min_angular_velocity)) {
+        return false;
+    }
+
+    PrecomputeAngles(scan.angle_min, scan.angle_increment, size);
+    x_.resize(size);
+    y_.resize(size);
+
+    // Every beam is moved by the motion from its own time to the end of the
+    // sweep: a turn by theta and the chord of the arc, which points half way
+    // into the turn. The LRF in front of the centre swings round with the
+    // turn on top of that. Theta stays small over a sweep, so the sines and
+    // cosines are their Taylor series
+    const float* range = &scan.ranges[0];
+    const float* beam_cos = &cos_[0];
+    const float* beam_sin = &sin_[0];
+    float* x = &x_[0];
+    float* y = &y_[0];
+    float last = static_cast<float>(size - 1);
+    float step = static_cast<float>(beam_time);
+    float linear = static_cast<float>(linear_velocity);
+    float angular = static_cast<float>(angular_velocity);
+    float offset = static_cast<float>(laser_offset_);
+    for (size_t i = 0; i < size; ++i) {
+        float dt = (last - i) * step;
+        float theta = angular * dt;
+        float theta_2 = theta * theta;
+        float cos_theta = 1 - theta_2 / 2 + theta_2 * theta_2 / 24;
+        float sin_theta = theta * (1 - theta_2 / 6);
+        float half_2 = theta_2 / 4;
+        float chord = linear * dt;
+        float move_x = chord * (1 - half_2 / 2) - offset * (1 - cos_theta);
+        float move_y = chord * theta / 2 * (1 - half_2 / 6) + offset * sin_theta;
+        float point_x = range[i] * beam_cos[i] - move_x;
+        float point_y = range[i] * beam_sin[i] - move_y;
+        x[i] = cos_theta * point_x + sin_theta * point_y;
+        y[i] = cos_theta * point_y - sin_theta * point_x;
+    }
+
+    // Put the points back into beams. A beam hit by several points keeps the
+    // closest, one hit by none keeps its measured range
+    std::vector<unsigned char> filled(size, 0);
+    for (size_t i = 0; i < size; ++i) {
+        float measured = scan.ranges[i];
+        if (!(measured >= scan.range_min && measured < scan.range_max)) {
+            continue;
+        }
+        double angle = std::atan2(y_[i], x_[i]);
+        double index = (angle - scan.angle_min) / scan.angle_increment;
+        long beam = static_cast<long>(std::floor(index + 0.5));
+        if (beam < 0 || beam >= static_cast<long>(size)) {
+            continue;
+        }
+        float distance = std::sqrt(x_[i] * x_[i] + y_[i] * y_[i]);
+        if (!filled[beam] || distance < ranges[beam]) {
+            ranges[beam] = distance;
+            filled[beam] = 1;
+        }
+    }
+
+    // The beams spread apart while the robot turns against the sweep, which
+    // leaves single beams without a point. Between two points on the same
+    // surface the gap is closed from both sides
+    for (size_t i = 1; i + 1 < size; ++i) {
+        if (!filled[i] && filled[i - 1] && filled[i + 1]
+                && std::fabs(ranges[i - 1] - ranges[i + 1]) < max_gap_share * ranges[i - 1]) {
+            ranges[i] = (ranges[i - 1] + ranges[i + 1]) / 2;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,265 @@
+/**
+ * @file scan_matcher.cpp
+ * @brief This file contains the implementation of the estimation of the
+ * motion of the robot from two consecutive laser scans.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "scan_matcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Fewer paired points than this do not fix the motion well enough
+const int min_matched_points = 30;
+
+// The grid over the reference points never has more cells than this
+const int max_grid_cells = 250000;
+
+// A match stops once an iteration moves the estimate less than this, in
+// metres and radians
+const double converged_step = 1e-4;
+
+// Solves the symmetric 3 x 3 system a * x = b by Cramer's rule, with a given
+// as a00, a01, a02, a11, a12, a22. Returns false if it is singular
+bool Solve3(const double a[6], const double b[3], double x[3]) {
+    double c00 = a[3] * a[5] - a[4] * a[4];
+    double c01 = a[2] * a[4] - a[1] * a[5];
+    double c02 = a[1] * a[4] - a[2] * a[3];
+    double det = a[0] * c00 + a[1] * c01 + a[2] * c02;
+    if (std::fabs(det) < 1e-12) {
+        return false;
+    }
+    double c11 = a[0] * a[5] - a[2] * a[2];
+    double c12 = a[1] * a[2] - a[0] * a[4];
+    double c22 = a[0] * a[3] - a[1] * a[1];
+    x[0] = (c00 * b[0] + c01 * b[1] + c02 * b[2]) / det;
+    x[1] = (c01 * b[0] + c11 * b[1] + c12 * b[2]) / det;
+    x[2] = (c02 * b[0] + c12 * b[1] + c22 * b[2]) / det;
+    return true;
+}
+
+}
+
+ScanMatcher::ScanMatcher() : max_iterations_(20), max_match_distance_(0.3),
+    grid_x_(0), grid_y_(0), cell_size_(0.3f), grid_width_(0), grid_height_(0) {
+}
+
+void ScanMatcher::SetParams(int max_iterations, double max_match_distance) {
+    max_iterations_ = max_iterations;
+    max_match_distance_ = max_match_distance;
+}
+
+void ScanMatcher::ScanToPoints(const std::vector<float>& ranges, double angle_min,
+                               double angle_increment, double range_min, double range_max,
+                               std::vector<float>& x, std::vector<float>& y) {
+    x.clear();
+    y.clear();
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        float range = ranges[i];
+        if (!(range >= range_min && range < range_max)) {
+            continue;
+        }
+        double angle = angle_min + i * angle_increment;
+        x.push_back(range * static_cast<float>(std::cos(angle)));
+        y.push_back(range * static_cast<float>(std::sin(angle)));
+    }
+}
+
+void ScanMatcher::SetReference(const std::vector<float>& ranges, double angle_min,
+                               double angle_increment, double range_min, double range_max) {
+    ScanToPoints(ranges, angle_min, angle_increment, range_min, range_max, x_, y_);
+
+    // A point gets the normal of the line through its neighbours along the
+    // scan. Points without a close neighbour lie on no line and are dropped
+    ref_x_.clear();
+    ref_y_.clear();
+    normal_x_.clear();
+    normal_y_.clear();
+    float max_gap = static_cast<float>(max_match_distance_);
+    int size = x_.size();
+    for (int i = 0; i < size; ++i) {
+        int before = i > 0 ? i - 1 : i, after = i + 1 < size ? i + 1 : i;
+        if (std::hypot(x_[i] - x_[before], y_[i] - y_[before]) > max_gap) {
+            before = i;
+        }
+        if (std::hypot(x_[after] - x_[i], y_[after] - y_[i]) > max_gap) {
+            after = i;
+        }
+        float tangent_x = x_[after] - x_[before], tangent_y = y_[after] - y_[before];
+        float length = std::hypot(tangent_x, tangent_y);
+        if (before == after || length <= 0) {
+            continue;
+        }
+        ref_x_.push_back(x_[i]);
+        ref_y_.push_back(y_[i]);
+        normal_x_.push_back(-tangent_y / length);
+        normal_y_.push_back(tangent_x / length);
+    }
+
+    // Sorts the points into the grid by counting them per cell first
+    cell_start_.clear();
+    cell_points_.clear();
+    grid_width_ = grid_height_ = 0;
+    int points = ref_x_.size();
+    if (points == 0) {
+        return;
+    }
+    float min_x = *std::min_element(ref_x_.begin(), ref_x_.end());
+    float max_x = *std::max_element(ref_x_.begin(), ref_x_.end());
+    float min_y = *std::min_element(ref_y_.begin(), ref_y_.end());
+    float max_y = *std::max_element(ref_y_.begin(), ref_y_.end());
+    cell_size_ = static_cast<float>(max_match_distance_);
+    double area = (max_x - min_x) * (max_y - min_y);
+    if (area / (cell_size_ * cell_size_) > max_grid_cells) {
+        cell_size_ = static_cast<float>(std::sqrt(area / max_grid_cells));
+    }
+    grid_x_ = min_x;
+    grid_y_ = min_y;
+    grid_width_ = static_cast<int>((max_x - min_x) / cell_size_) + 1;
+    grid_height_ = static_cast<int>((max_y - min_y) / cell_size_) + 1;
+
+    std::vector<int> cell(points);
+    cell_start_.assign(grid_width_ * grid_height_ + 1, 0);
+    for (int i = 0; i < points; ++i) {
+        int cell_x = std::min(static_cast<int>((ref_x_[i] - grid_x_) / cell_size_), grid_width_ - 1);
+        int cell_y = std::min(static_cast<int>((ref_y_[i] - grid_y_) / cell_size_), grid_height_ - 1);
+        cell[i] = cell_y * grid_width_ + cell_x;
+        ++cell_start_[cell[i] + 1];
+    }
+    for (size_t i = 1; i < cell_start_.size(); ++i) {
+        cell_start_[i] += cell_start_[i - 1];
+    }
+    std::vector<int> next(cell_start_.begin(), cell_start_.end() - 1);
+    cell_points_.resize(points);
+    for (int i = 0; i < points; ++i) {
+        cell_points_[next[cell[i]]++] = i;
+    }
+}
+
+bool ScanMatcher::HasReference() const {
+    return static_cast<int>(ref_x_.size()) >= min_matched_points;
+}
+
+int ScanMatcher::ClosestReference(float x, float y) const {
+    float grid_x = (x - grid_x_) / cell_size_, grid_y = (y - grid_y_) / cell_size_;
+    if (!(grid_x > -1 && grid_x < grid_width_ + 1 && grid_y > -1 && grid_y < grid_height_ + 1)) {
+        return -1;
+    }
+    int cell_x = static_cast<int>(std::floor(grid_x));
+    int cell_y = static_cast<int>(std::floor(grid_y));
+
+    int closest = -1;
+    float best = static_cast<float>(max_match_distance_ * max_match_distance_);
+    for (int ny = std::max(cell_y - 1, 0); ny <= std::min(cell_y + 1, grid_height_ - 1); ++ny) {
+        for (int nx = std::max(cell_x - 1, 0); nx <= std::min(cell_x + 1, grid_width_ - 1); ++nx) {
+            int cell = ny * grid_width_ + nx;
+            for (int k = cell_start_[cell]; k < cell_start_[cell + 1]; ++k) {
+                int i = cell_points_[k];
+                float dx = ref_x_[i] - x, dy = ref_y_[i] - y;
+                float distance = dx * dx + dy * dy;
+                if (distance < best) {
+                    best = distance;
+                    closest = i;
+                }
+            }
+        }
+    }
+    return closest;
+}
+
+bool ScanMatcher::Match(const std::vector<float>& ranges, double angle_min,
+                        double angle_increment, double range_min, double range_max,
+                        const Pose2D& guess, Pose2D& motion) {
+    if (!HasReference()) {
+        return false;
+    }
+    ScanToPoints(ranges, angle_min, angle_increment, range_min, range_max, x_, y_);
+    int size = x_.size();
+    if (size < min_matched_points) {
+        return false;
+    }
+    moved_x_.resize(size);
+    moved_y_.resize(size);
+    weight_.resize(size);
+    match_normal_x_.resize(size);
+    match_normal_y_.resize(size);
+    match_offset_.resize(size);
+
+    Pose2D estimate = guess;
+    int matched = 0;
+    for (int iteration = 0; iteration < max_iterations_; ++iteration) {
+        float cos_theta = static_cast<float>(std::cos(estimate.theta_));
+        float sin_theta = static_cast<float>(std::sin(estimate.theta_));
+        float shift_x = static_cast<float>(estimate.x_), shift_y = static_cast<float>(estimate.y_);
+        for (int i = 0; i < size; ++i) {
+            moved_x_[i] = cos_theta * x_[i] - sin_theta * y_[i] + shift_x;
+            moved_y_[i] = sin_theta * x_[i] + cos_theta * y_[i] + shift_y;
+        }
+
+        // Points without a partner keep a weight of 0 and a line through the
+        // origin, so the sums below need no branches
+        matched = 0;
+        for (int i = 0; i < size; ++i) {
+            int partner = ClosestReference(moved_x_[i], moved_y_[i]);
+            if (partner < 0) {
+                weight_[i] = 0;
+                match_normal_x_[i] = match_normal_y_[i] = match_offset_[i] = 0;
+                continue;
+            }
+            ++matched;
+            weight_[i] = 1;
+            match_normal_x_[i] = normal_x_[partner];
+            match_normal_y_[i] = normal_y_[partner];
+            match_offset_[i] = normal_x_[partner] * ref_x_[partner]
+                               + normal_y_[partner] * ref_y_[partner];
+        }
+        if (matched < min_matched_points) {
+            return false;
+        }
+
+        // The distance of a moved point to its line is n . p - d. A small
+        // step (dx, dy, dtheta) changes it by nx dx + ny dy + (n x r) dtheta,
+        // with r the point rotated but not yet shifted
+        float a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+        float b0 = 0, b1 = 0, b2 = 0;
+        for (int i = 0; i < size; ++i) {
+            float nx = match_normal_x_[i], ny = match_normal_y_[i], w = weight_[i];
+            float residual = nx * moved_x_[i] + ny * moved_y_[i] - match_offset_[i];
+            float turn = nx * (shift_y - moved_y_[i]) + ny * (moved_x_[i] - shift_x);
+            a00 += w * nx * nx;
+            a01 += w * nx * ny;
+            a02 += w * nx * turn;
+            a11 += w * ny * ny;
+            a12 += w * ny * turn;
+            a22 += w * turn * turn;
+            b0 -= w * nx * residual;
+            b1 -= w * ny * residual;
+            b2 -= w * turn * residual;
+        }
+        double a[6] = {a00, a01, a02, a11, a12, a22};
+        double b[3] = {b0, b1, b2};
+        double step[3];
+        if (!Solve3(a, b, step)) {
+            return false;
+        }
+        estimate.x_ += step[0];
+        estimate.y_ += step[1];
+        estimate.theta_ = NormaliseAngle(estimate.theta_ + step[2]);
+        if (std::fabs(step[0]) < converged_step && std::fabs(step[1]) < converged_step
+                && std::fabs(step[2]) < converged_step) {
+            break;
+        }
+    }
+
+    motion = estimate;
+    return true;
+}
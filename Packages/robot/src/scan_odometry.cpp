@@ -0,0 +1,96 @@
+/**
+ * @file scan_odometry.cpp
+ * @brief This file contains the implementation of the odometry of the robot
+ * from its laser scans.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "scan_odometry.h"
+
+#include <cmath>
+#include <string>
+
+ScanOdometry::ScanOdometry() {
+    pose_ = MakePose(0, 0, 0);
+    last_motion_ = pose_;
+    Initialise();
+}
+
+void ScanOdometry::Initialise() {
+    bool loaded = true;
+    std::string laser_topic, odometry_topic;
+    int max_iterations;
+    double max_match_distance;
+
+    if (!node_.getParam("/scan_odometry_laser_topic", laser_topic)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/scan_odometry_topic", odometry_topic)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/scan_odometry_max_iterations", max_iterations)) {
+        loaded = false;
+    }
+
+    if (!node_.getParam("/scan_odometry_max_match_distance", max_match_distance)) {
+        loaded = false;
+    }
+
+    if (loaded == false) {
+        ROS_INFO("Scan odometry parameters failed to load!");
+        ros::shutdown();
+        return;
+    }
+
+    matcher_.SetParams(max_iterations, max_match_distance);
+    odom_pub_ = node_.advertise<nav_msgs::Odometry>(odometry_topic, 100);
+    laser_sub_ = node_.subscribe(laser_topic, 100, &ScanOdometry::LaserCallback, this);
+}
+
+void ScanOdometry::LaserCallback(const sensor_msgs::LaserScan::ConstPtr& msg) {
+    Pose2D motion;
+    bool matched = matcher_.HasReference()
+                   && matcher_.Match(msg->ranges, msg->angle_min, msg->angle_increment,
+                                     msg->range_min, msg->range_max, last_motion_, motion);
+    if (!matched) {
+        // Without a match the robot is taken to stand still, the next scan
+        // is matched against this one
+        motion = MakePose(0, 0, 0);
+    }
+    matcher_.SetReference(msg->ranges, msg->angle_min, msg->angle_increment,
+                          msg->range_min, msg->range_max);
+
+    double cos_theta = std::cos(pose_.theta_), sin_theta = std::sin(pose_.theta_);
+    pose_.x_ += cos_theta * motion.x_ - sin_theta * motion.y_;
+    pose_.y_ += sin_theta * motion.x_ + cos_theta * motion.y_;
+    pose_.theta_ = NormaliseAngle(pose_.theta_ + motion.theta_);
+    last_motion_ = motion;
+
+    nav_msgs::Odometry odometry;
+    odometry.header.stamp = msg->header.stamp;
+    odometry.header.frame_id = "odom";
+    odometry.child_frame_id = msg->header.frame_id;
+    odometry.pose.pose.position.x = pose_.x_;
+    odometry.pose.pose.position.y = pose_.y_;
+    odometry.pose.pose.orientation.z = std::sin(pose_.theta_ / 2);
+    odometry.pose.pose.orientation.w = std::cos(pose_.theta_ / 2);
+
+    // The velocities are in the frame of the robot, as in the odometry of
+    // the robot itself
+    double dt = last_stamp_.isZero() ? 0 : (msg->header.stamp - last_stamp_).toSec();
+    if (dt > 0) {
+        odometry.twist.twist.linear.x = motion.x_ / dt;
+        odometry.twist.twist.linear.y = motion.y_ / dt;
+        odometry.twist.twist.angular.z = motion.theta_ / dt;
+    }
+    last_stamp_ = msg->header.stamp;
+
+    odom_pub_.publish(odometry);
+}
@@ -0,0 +1,32 @@
+/** 
+ * @file scan_odometry_node.cpp
+ * @brief This file creates the ScanOdometry ros node which publishes the
+ * odometry found from the laser scans
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <ros/ros.h>
+#include "scan_odometry.h"
+
+/**
+ * \cond
+ */
+int main(int argc, char** argv)
+{
+    ros::init(argc, argv, "ScanOdometry");
+
+    ScanOdometry scan_odometry;
+
+    ros::spin();
+
+    return 0;
+}
+
+/**
+ * \endcond
+ */
@@ -0,0 +1,185 @@
+/**
+ * @file split_hough.cpp
+ * @brief This file contains the implementation of the Hough transform split
+ * into parallel jobs.
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include "split_hough.h"
+#include "detect_helpers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <vector>
+
+namespace {
+
+// Pixels beyond an edge point the Sobel and Canny steps of cv::HoughCircles
+// look at
+const int edge_reach = 2;
+
+/**
+ * @brief A circle together with its support, used for sorting
+ */
+struct ScoredCircle {
+    cv::Vec3f circle_;
+    float support_;
+};
+
+bool CompareSupport(const ScoredCircle& a, const ScoredCircle& b) {
+    return a.support_ > b.support_;
+}
+
+}
+
+/**
+ * @brief Runs a range of jobs. Every job writes its own result, so the jobs
+ * run in parallel without locking.
+ */
+class HoughJobBody : public cv::ParallelLoopBody {
+public:
+    HoughJobBody(const cv::Mat& image, const std::vector<HoughJob>& jobs,
+                 const HoughParams& params, const Deadline& deadline,
+                 std::vector<std::vector<cv::Vec3f> >& results, std::vector<uchar>& done)
+        : image_(image), jobs_(jobs), params_(params), deadline_(deadline),
+          results_(results), done_(done) {
+    }
+
+    void operator()(const cv::Range& range) const {
+        for (int i = range.start; i < range.end; ++i) {
+            //a started job cannot be interrupted, so the clock is read between jobs
+            if (deadline_.Expired()) {
+                return;
+            }
+            done_[i] = 1;
+            const HoughJob& job = jobs_[i];
+            std::vector<cv::Vec3f> circles;
+            cv::Mat tile = image_(job.tile_);
+            cv::HoughCircles(tile, circles, CV_HOUGH_GRADIENT,
+                             params_.dp_, params_.min_dist_,
+                             params_.threshold_1_, params_.threshold_2_,
+                             job.min_radius_, job.max_radius_);
+
+            //centres outside the core belong to a neighbouring tile
+            for (size_t j = 0; j < circles.size(); ++j) {
+                cv::Vec3f circle = circles[j];
+                circle[0] += job.tile_.x;
+                circle[1] += job.tile_.y;
+                int x = cvFloor(circle[0]), y = cvFloor(circle[1]);
+                if (job.core_.contains(cv::Point(x, y))) {
+                    results_[i].push_back(circle);
+                }
+            }
+        }
+    }
+
+private:
+    const cv::Mat& image_;
+    const std::vector<HoughJob>& jobs_;
+    const HoughParams& params_;
+    const Deadline& deadline_;
+    std::vector<std::vector<cv::Vec3f> >& results_;
+    std::vector<uchar>& done_;
+};
+
+void PlanHoughJobs(const cv::Rect& window, const HoughParams& params,
+                   const SplitParams& split, std::vector<HoughJob>& jobs) {
+    jobs.clear();
+    if (window.area() == 0) {
+        return;
+    }
+
+    //there is no point in more parts than radii, or more tiles than pixels
+    int radii = params.max_radius_ - params.min_radius_ + 1;
+    int splits = std::max(1, std::min(split.radius_splits_, radii));
+    int tiles = std::max(1, std::min(split.tiles_, std::min(window.width, window.height)));
+    int margin = params.max_radius_ + edge_reach * std::max(1, params.dp_) + 1;
+
+    for (int part = 0; part < splits; ++part) {
+        int min_radius = params.min_radius_ + part * radii / splits;
+        int max_radius = params.min_radius_ + (part + 1) * radii / splits - 1;
+        for (int row = 0; row < tiles; ++row) {
+            for (int col = 0; col < tiles; ++col) {
+                HoughJob job;
+                int x = window.x + col * window.width / tiles;
+                int y = window.y + row * window.height / tiles;
+                job.core_ = cv::Rect(x, y, window.x + (col + 1) * window.width / tiles - x,
+                                     window.y + (row + 1) * window.height / tiles - y);
+                job.tile_ = cv::Rect(job.core_.x - margin, job.core_.y - margin,
+                                     job.core_.width + 2 * margin, job.core_.height + 2 * margin);
+                job.tile_ &= window;
+                //neighbouring parts overlap by a pixel so no radius is lost
+                //to rounding on the border
+                job.min_radius_ = std::max(params.min_radius_, min_radius - (part > 0 ? 1 : 0));
+                job.max_radius_ = max_radius;
+                jobs.push_back(job);
+            }
+        }
+    }
+}
+
+float RingSupport(const cv::Mat& image, const cv::Vec3f& circle) {
+    int samples = std::max(8, cvRound(2 * M_PI * circle[2]));
+    float sum = 0;
+    for (int i = 0; i < samples; ++i) {
+        double angle = 2 * M_PI * i / samples;
+        int x = cvRound(circle[0] + circle[2] * cos(angle));
+        int y = cvRound(circle[1] + circle[2] * sin(angle));
+        if (x >= 0 && y >= 0 && x < image.cols && y < image.rows) {
+            sum += image.at<uchar>(y, x);
+        }
+    }
+    return sum / samples;
+}
+
+void MergeCircles(const cv::Mat& image, const std::vector<std::vector<cv::Vec3f> >& results,
+                  int min_dist, std::vector<cv::Vec3f>& circles) {
+    std::vector<ScoredCircle> scored;
+    for (size_t i = 0; i < results.size(); ++i) {
+        for (size_t j = 0; j < results[i].size(); ++j) {
+            ScoredCircle candidate;
+            candidate.circle_ = results[i][j];
+            candidate.support_ = RingSupport(image, results[i][j]);
+            scored.push_back(candidate);
+        }
+    }
+    //ties keep the job order, so the result is the same for every thread count
+    std::stable_sort(scored.begin(), scored.end(), CompareSupport);
+
+    //Non maximum suppression with the same semantics as cv::HoughCircles
+    circles.clear();
+    float min_dist_2 = static_cast<float>(min_dist) * min_dist;
+    for (size_t i = 0; i < scored.size(); ++i) {
+        bool keep = true;
+        for (size_t j = 0; j < circles.size() && keep; ++j) {
+            float dx = scored[i].circle_[0] - circles[j][0];
+            float dy = scored[i].circle_[1] - circles[j][1];
+            keep = dx * dx + dy * dy >= min_dist_2;
+        }
+        if (keep) {
+            circles.push_back(scored[i].circle_);
+        }
+    }
+}
+
+bool SplitHoughCircles(const cv::Mat& image, const cv::Rect& window,
+                       const HoughParams& params, const SplitParams& split,
+                       std::vector<cv::Vec3f>& circles, const Deadline& deadline) {
+    std::vector<HoughJob> jobs;
+    PlanHoughJobs(window, params, split, jobs);
+
+    std::vector<std::vector<cv::Vec3f> > results(jobs.size());
+    std::vector<uchar> done(jobs.size(), 0);
+    HoughJobBody body(image, jobs, params, deadline, results, done);
+    cv::parallel_for_(cv::Range(0, static_cast<int>(jobs.size())), body);
+
+    MergeCircles(image, results, params.min_dist_, circles);
+    return std::find(done.begin(), done.end(), 0) == done.end();
+}
@@ -12,6 +12,8 @@
 #include "util_functions.h"
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 double GetMin(std::vector<float>& ranges, int start, int finish) {
     if (ranges.size() <= 0 || start < 0 || finish > ranges.size() ||
@@ -42,3 +44,65 @@ double Min(double right_min_distance, double left_min_distance,
     }
     return min;
 }
+
+double PursuitCurvature(double forward, double left) {
+    double squared_distance = forward * forward + left * left;
+    if (squared_distance <= 0) {
+        return 0;
+    }
+    return 2 * left / squared_distance;
+}
+
+void ArcVelocities(double forward, double left, double max_angular_velocity,
+                   double& linear_velocity, double& angular_velocity) {
+    if (forward <= 0) {
+        linear_velocity = 0;
+        angular_velocity = left > 0 ? max_angular_velocity : -max_angular_velocity;
+        return;
+    }
+    angular_velocity = linear_velocity * PursuitCurvature(forward, left);
+    if (std::fabs(angular_velocity) > max_angular_velocity) {
+        linear_velocity *= max_angular_velocity / std::fabs(angular_velocity);
+        angular_velocity = angular_velocity > 0 ? max_angular_velocity : -max_angular_velocity;
+    }
+}
+
+double ApproachVelocity(double free_distance, double min_velocity,
+                        double max_velocity, double deceleration) {
+    double velocity = std::sqrt(2 * deceleration * std::max(free_distance, 0.0));
+    return std::max(min_velocity, std::min(velocity, max_velocity));
+}
+
+void ScanToPoints(const std::vector<float>& ranges, std::vector<float>& x,
+                  std::vector<float>& y) {
+    int size = ranges.size();
+    x.resize(size);
+    y.resize(size);
+    for (int i = 0; i < size; ++i) {
+        double angle = (i * 240.0 / size - 30) / 180 * M_PI;
+        x[i] = ranges[i] * std::cos(angle);
+        y[i] = ranges[i] * std::sin(angle);
+    }
+}
+
+double CorridorFreeDistance(const std::vector<float>& x, const std::vector<float>& y,
+                            double goal_x, double goal_y, double half_width) {
+    double length = std::sqrt(goal_x * goal_x + goal_y * goal_y);
+    if (length <= 0) {
+        return 0;
+    }
+
+    // Every point is split into the distance along the way and the distance
+    // to the side of it. The loop has no branches so it can be vectorised
+    float along_x = goal_x / length, along_y = goal_y / length;
+    float width = half_width;
+    float free_distance = std::numeric_limits<float>::infinity();
+    int size = std::min(x.size(), y.size());
+    for (int i = 0; i < size; ++i) {
+        float along = x[i] * along_x + y[i] * along_y;
+        float side = std::fabs(x[i] * along_y - y[i] * along_x);
+        bool inside = along >= 0 && side < width;
+        free_distance = std::min(free_distance, inside ? along : free_distance);
+    }
+    return std::min(static_cast<double>(free_distance), length);
+}
@@ -0,0 +1,130 @@
+/**
+ * @file CD_arc_prefilter_test.cpp
+ * @brief This file contains the unit tests for the arc prefilter of the
+ * circle detector
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "arc_prefilter.h"
+#include "detect_helpers.h"
+
+const double angle_min = -120 * M_PI / 180;
+const double angle_increment = 240 * M_PI / 180 / 720;
+
+// Range of a beam to a segment from (x1, y1) to (x2, y2), or 5 if missed
+double HitSegment(double angle, double x1, double y1, double x2, double y2) {
+	double dx = cos(angle), dy = sin(angle);
+	double ex = x2 - x1, ey = y2 - y1;
+	double denominator = dx * ey - dy * ex;
+	if (fabs(denominator) < 1e-12) {
+		return 5;
+	}
+	double t = (x1 * ey - y1 * ex) / denominator;
+	double u = (x1 * dy - y1 * dx) / denominator;
+	return (t > 0 && u >= 0 && u <= 1) ? t : 5;
+}
+
+// Range of a beam to a circle, or 5 if missed
+double HitCircle(double angle, double cx, double cy, double radius) {
+	double dx = cos(angle), dy = sin(angle);
+	double b = cx * dx + cy * dy;
+	double c = cx * cx + cy * cy - radius * radius;
+	if (b * b - c < 0 || b - sqrt(b * b - c) <= 0) {
+		return 5;
+	}
+	return b - sqrt(b * b - c);
+}
+
+// A corridor with a wall in front, optionally a box and a circle
+std::vector<float> SimulateScan(bool box, bool circle) {
+	std::vector<float> ranges;
+	for (int i = 0; i < 720; ++i) {
+		double angle = angle_min + i * angle_increment;
+		double range = 5;
+		range = std::min(range, HitSegment(angle, -1, -0.6, 3, -0.6));
+		range = std::min(range, HitSegment(angle, -1, 0.6, 3, 0.6));
+		range = std::min(range, HitSegment(angle, 1.8, -0.6, 1.8, 0.6));
+		if (box) {
+			range = std::min(range, HitSegment(angle, 0.8, -0.1, 1.0, -0.1));
+			range = std::min(range, HitSegment(angle, 0.8, -0.1, 0.8, 0.1));
+			range = std::min(range, HitSegment(angle, 0.8, 0.1, 1.0, 0.1));
+		}
+		if (circle) {
+			range = std::min(range, HitCircle(angle, 1.2, 0.3, 0.15));
+		}
+		ranges.push_back(range);
+	}
+	return ranges;
+}
+
+ArcParams TestParams() {
+	ArcParams params;
+	params.enabled_ = true;
+	params.min_radius_ = 0.075;
+	params.max_radius_ = 0.6;
+	params.jump_distance_ = 0.1;
+	params.max_range_ = 2;
+	return params;
+}
+
+TEST(ArcPrefilter, WallsOnly) {
+	std::vector<float> ranges = SimulateScan(false, false);
+	ASSERT_FALSE(HasArcCandidate(ranges, angle_min, angle_increment, TestParams()));
+}
+
+TEST(ArcPrefilter, BoxCorners) {
+	std::vector<float> ranges = SimulateScan(true, false);
+	ASSERT_FALSE(HasArcCandidate(ranges, angle_min, angle_increment, TestParams()));
+}
+
+TEST(ArcPrefilter, Circle) {
+	std::vector<float> ranges = SimulateScan(false, true);
+	ASSERT_TRUE(HasArcCandidate(ranges, angle_min, angle_increment, TestParams()));
+}
+
+TEST(ArcPrefilter, CircleOutOfRange) {
+	std::vector<float> ranges = SimulateScan(false, true);
+	ArcParams params = TestParams();
+	params.max_range_ = 1;
+	ASSERT_FALSE(HasArcCandidate(ranges, angle_min, angle_increment, params));
+}
+
+TEST(ArcPrefilter, EmptyScan) {
+	std::vector<float> ranges;
+	ASSERT_FALSE(HasArcCandidate(ranges, angle_min, angle_increment, TestParams()));
+}
+
+TEST(ArcGate, SkipsWallsWithHistory) {
+	// Three scans searched together, as with local_map_scans: 3
+	ArcGate gate;
+	std::vector<float> walls = SimulateScan(false, false);
+	std::vector<float> circle = SimulateScan(false, true);
+	for (int i = 0; i < 5; ++i) {
+		ASSERT_FALSE(gate.Pass(HasArcCandidate(walls, angle_min, angle_increment, TestParams()), 3));
+	}
+
+	// The two scans after a circle are searched together with it
+	ASSERT_TRUE(gate.Pass(HasArcCandidate(circle, angle_min, angle_increment, TestParams()), 3));
+	ASSERT_TRUE(gate.Pass(HasArcCandidate(walls, angle_min, angle_increment, TestParams()), 3));
+	ASSERT_TRUE(gate.Pass(HasArcCandidate(walls, angle_min, angle_increment, TestParams()), 3));
+	ASSERT_FALSE(gate.Pass(HasArcCandidate(walls, angle_min, angle_increment, TestParams()), 3));
+}
+
+TEST(ArcGate, SingleScan) {
+	ArcGate gate;
+	ASSERT_TRUE(gate.Pass(true, 1));
+	ASSERT_FALSE(gate.Pass(false, 1));
+}
+
+int main(int argc, char **argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
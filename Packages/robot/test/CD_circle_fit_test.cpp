@@ -0,0 +1,138 @@
+/**
+ * @file CD_circle_fit_test.cpp
+ * @brief This file contains the unit tests for the least-squares circle fitting
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "circle_fit.h"
+
+// Points on the part of a circle facing the origin
+std::vector<cv::Point2f> Arc(cv::Point2f centre, float radius, int count) {
+	std::vector<cv::Point2f> points;
+	double facing = atan2(-centre.y, -centre.x);
+	for (int i = 0; i < count; ++i) {
+		double angle = facing - M_PI / 3 + i * (2 * M_PI / 3) / (count - 1);
+		points.push_back(cv::Point2f(centre.x + radius * cos(angle), centre.y + radius * sin(angle)));
+	}
+	return points;
+}
+
+TEST(CircleFit, AlgebraicExactArc) {
+	std::vector<cv::Point2f> points = Arc(cv::Point2f(0.3, 0.8), 0.15, 30);
+	cv::Point2f centre;
+	float radius;
+	ASSERT_TRUE(FitCircleAlgebraic(points, centre, radius));
+	ASSERT_NEAR(0.3, centre.x, 1e-4);
+	ASSERT_NEAR(0.8, centre.y, 1e-4);
+	ASSERT_NEAR(0.15, radius, 1e-4);
+}
+
+TEST(CircleFit, AlgebraicTooFewPoints) {
+	std::vector<cv::Point2f> points = Arc(cv::Point2f(0.3, 0.8), 0.15, 30);
+	points.resize(2);
+	cv::Point2f centre;
+	float radius;
+	ASSERT_FALSE(FitCircleAlgebraic(points, centre, radius));
+}
+
+TEST(CircleFit, AlgebraicCollinear) {
+	std::vector<cv::Point2f> points;
+	for (int i = 0; i < 10; ++i) {
+		points.push_back(cv::Point2f(i * 0.1, 1));
+	}
+	cv::Point2f centre;
+	float radius;
+	ASSERT_FALSE(FitCircleAlgebraic(points, centre, radius));
+}
+
+TEST(CircleFit, SelectCirclePoints) {
+	std::vector<cv::Point2f> points = Arc(cv::Point2f(0, 1), 0.2, 10);
+	points.push_back(cv::Point2f(0, 0.5));
+	points.push_back(cv::Point2f(1, 1));
+	std::vector<cv::Point2f> selected;
+	SelectCirclePoints(points, cv::Point2f(0, 1), 0.2, 0.01, selected);
+	ASSERT_EQ(10, selected.size());
+}
+
+TEST(CircleFit, GeometricFromOffsetGuess) {
+	std::vector<cv::Point2f> points = Arc(cv::Point2f(0.3, 0.8), 0.15, 30);
+	CircleFit fit;
+	fit.centre_ = cv::Point2f(0.33, 0.76);
+	fit.radius_ = 0.2;
+	ASSERT_TRUE(FitCircleGeometric(points, fit, 10));
+	ASSERT_NEAR(0.3, fit.centre_.x, 1e-4);
+	ASSERT_NEAR(0.8, fit.centre_.y, 1e-4);
+	ASSERT_NEAR(0.15, fit.radius_, 1e-4);
+	ASSERT_NEAR(0, fit.residual_, 1e-4);
+}
+
+TEST(CircleFit, GeometricResidual) {
+	std::vector<cv::Point2f> points = Arc(cv::Point2f(0, 1), 0.15, 40);
+	// Alternately push the points 1cm out of and into the circle
+	for (size_t i = 0; i < points.size(); ++i) {
+		float sign = i % 2 == 0 ? 1 : -1;
+		float dx = points[i].x, dy = points[i].y - 1;
+		points[i].x += sign * 0.01 * dx / 0.15;
+		points[i].y += sign * 0.01 * dy / 0.15;
+	}
+	CircleFit fit;
+	fit.centre_ = cv::Point2f(0, 1);
+	fit.radius_ = 0.15;
+	ASSERT_TRUE(FitCircleGeometric(points, fit, 5));
+	ASSERT_NEAR(0.01, fit.residual_, 1e-3);
+	ASSERT_NEAR(0.15, fit.radius_, 1e-3);
+}
+
+TEST(CircleFit, GeometricTooFewPoints) {
+	std::vector<cv::Point2f> points = Arc(cv::Point2f(0.3, 0.8), 0.15, 2);
+	CircleFit fit;
+	fit.centre_ = cv::Point2f(0.3, 0.8);
+	fit.radius_ = 0.15;
+	fit.residual_ = -1;
+	ASSERT_FALSE(FitCircleGeometric(points, fit, 5));
+	ASSERT_FLOAT_EQ(-1, fit.residual_);
+}
+
+TEST(CircleFit, Confidence) {
+	CircleFit fit;
+	fit.centre_ = cv::Point2f(0, 1);
+	fit.radius_ = 0.15;
+	fit.residual_ = 0;
+	ASSERT_FLOAT_EQ(1, FitConfidence(fit, 0.01));
+	fit.residual_ = 0.01;
+	ASSERT_FLOAT_EQ(0.5, FitConfidence(fit, 0.01));
+	float worse = FitConfidence(fit, 0.005);
+	ASSERT_LT(worse, 0.5);
+	// A circle without a fit scores below a reasonable fit
+	fit.residual_ = -1;
+	ASSERT_LT(FitConfidence(fit, 0.01), worse);
+}
+
+TEST(CircleFit, MostConfident) {
+	std::vector<CircleFit> circles;
+	ASSERT_EQ(-1, MostConfident(circles));
+	CircleFit fit;
+	fit.centre_ = cv::Point2f(0, 1);
+	fit.radius_ = 0.15;
+	fit.residual_ = -1;
+	circles.push_back(fit);
+	ASSERT_EQ(0, MostConfident(circles));
+	fit.residual_ = 0.02;
+	circles.push_back(fit);
+	fit.residual_ = 0.01;
+	circles.push_back(fit);
+	ASSERT_EQ(2, MostConfident(circles));
+}
+
+int main(int argc, char **argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
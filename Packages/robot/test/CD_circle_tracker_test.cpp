@@ -0,0 +1,182 @@
+/**
+ * @file CD_circle_tracker_test.cpp
+ * @brief This file contains the unit tests for the tracker that follows the
+ * circle between scans
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "circle_tracker.h"
+#include "pose_helpers.h"
+
+TrackParams TestParams() {
+	TrackParams params;
+	params.enabled_ = true;
+	params.alpha_ = 0.5;
+	params.beta_ = 0;
+	params.gate_ = 0.3;
+	params.window_ = 0.25;
+	params.lock_hits_ = 3;
+	params.max_misses_ = 2;
+	params.full_search_frames_ = 4;
+	return params;
+}
+
+std::vector<CircleFit> Detection(float x, float y) {
+	CircleFit circle;
+	circle.centre_ = cv::Point2f(x, y);
+	circle.radius_ = 0.15;
+	circle.residual_ = 0.001;
+	return std::vector<CircleFit>(1, circle);
+}
+
+Pose2D NoMotion() {
+	Pose2D motion;
+	motion.x_ = motion.y_ = motion.theta_ = 0;
+	return motion;
+}
+
+TEST(CircleTracker, LocksAfterHits) {
+	CircleTracker tracker;
+	tracker.SetParams(TestParams());
+	for (int i = 0; i < 3; ++i) {
+		ASSERT_FALSE(tracker.Locked());
+		tracker.Predict(0.1, NoMotion());
+		ASSERT_EQ(0, tracker.Update(Detection(0.2, 1.0), 0.1));
+	}
+	ASSERT_TRUE(tracker.Locked());
+	ASSERT_EQ(3, tracker.Age());
+	ASSERT_DOUBLE_EQ(1, tracker.Confidence());
+	ASSERT_NEAR(0.2, tracker.Position().x, 1e-6);
+	ASSERT_NEAR(1.0, tracker.Position().y, 1e-6);
+}
+
+TEST(CircleTracker, CoastsThenDrops) {
+	CircleTracker tracker;
+	tracker.SetParams(TestParams());
+	std::vector<CircleFit> none;
+	for (int i = 0; i < 3; ++i) {
+		tracker.Update(Detection(0.2, 1.0), 0.1);
+	}
+
+	// Misses keep the hypothesis with a lower confidence
+	ASSERT_EQ(-1, tracker.Update(none, 0.1));
+	ASSERT_TRUE(tracker.Active());
+	ASSERT_LT(tracker.Confidence(), 1);
+	ASSERT_EQ(-1, tracker.Update(none, 0.1));
+	ASSERT_TRUE(tracker.Active());
+
+	ASSERT_EQ(-1, tracker.Update(none, 0.1));
+	ASSERT_FALSE(tracker.Active());
+	ASSERT_DOUBLE_EQ(0, tracker.Confidence());
+}
+
+TEST(CircleTracker, GatesFarDetections) {
+	CircleTracker tracker;
+	tracker.SetParams(TestParams());
+	tracker.Update(Detection(0.2, 1.0), 0.1);
+
+	std::vector<CircleFit> detections = Detection(-0.5, 0.5);
+	detections.push_back(Detection(0.25, 1.0)[0]);
+	ASSERT_EQ(1, tracker.Update(detections, 0.1));
+	ASSERT_NEAR(0.225, tracker.Position().x, 1e-6);
+}
+
+TEST(CircleTracker, StartsFromBestFit) {
+	CircleTracker tracker;
+	tracker.SetParams(TestParams());
+	std::vector<CircleFit> detections = Detection(-0.5, 0.5);
+	detections[0].residual_ = 0.01;
+	detections.push_back(Detection(0.25, 1.0)[0]);
+	ASSERT_EQ(1, tracker.Update(detections, 0.1));
+	ASSERT_TRUE(tracker.Active());
+	ASSERT_NEAR(0.25, tracker.Position().x, 1e-6);
+
+	// Locks on although every scan shows both circles
+	for (int i = 0; i < 2; ++i) {
+		tracker.Predict(0.1, NoMotion());
+		ASSERT_EQ(1, tracker.Update(detections, 0.1));
+	}
+	ASSERT_TRUE(tracker.Locked());
+}
+
+TEST(CircleTracker, FullSearchWhileLocked) {
+	CircleTracker tracker;
+	tracker.SetParams(TestParams());
+	// Locked on a decoy that never moves and is never missed
+	for (int i = 0; i < 3; ++i) {
+		ASSERT_FALSE(tracker.Windowed());
+		tracker.Update(Detection(0.2, 1.0), 0.1);
+	}
+	ASSERT_TRUE(tracker.Locked());
+	ASSERT_FALSE(tracker.Windowed());
+
+	// The full search finds the goal outside the window as well. The track
+	// stays on the decoy, the goal is another candidate
+	std::vector<CircleFit> detections = Detection(-1.5, 2.0);
+	detections.push_back(Detection(0.2, 1.0)[0]);
+	ASSERT_EQ(1, tracker.Update(detections, 0.1));
+
+	// Then the window is searched for three scans, every fourth is full
+	int full_searches = 0;
+	for (int i = 0; i < 8; ++i) {
+		ASSERT_TRUE(tracker.Locked());
+		if (!tracker.Windowed()) {
+			++full_searches;
+		}
+		tracker.Update(Detection(0.2, 1.0), 0.1);
+	}
+	ASSERT_EQ(2, full_searches);
+
+	// Without full searches a locked track always searches the window
+	TrackParams params = TestParams();
+	params.full_search_frames_ = 0;
+	tracker.SetParams(params);
+	ASSERT_TRUE(tracker.Windowed());
+}
+
+TEST(CircleTracker, PredictsWithOdometry) {
+	CircleTracker tracker;
+	tracker.SetParams(TestParams());
+	tracker.Update(Detection(0, 1.0), 0.1);
+
+	// Driving 0.5 m forward brings the circle 0.5 m closer
+	Pose2D forward = NoMotion();
+	forward.x_ = 0.5;
+	tracker.Predict(0.1, forward);
+	ASSERT_NEAR(0, tracker.Position().x, 1e-6);
+	ASSERT_NEAR(0.5, tracker.Position().y, 1e-6);
+
+	// Turning 90 degrees to the left puts the circle on the right
+	Pose2D left = NoMotion();
+	left.theta_ = M_PI / 2;
+	tracker.Predict(0.1, left);
+	ASSERT_NEAR(0.5, tracker.Position().x, 1e-6);
+	ASSERT_NEAR(0, tracker.Position().y, 1e-6);
+}
+
+TEST(PoseHelpers, RelativePose) {
+	Pose2D from, to;
+	from.x_ = 1;
+	from.y_ = 1;
+	from.theta_ = M_PI / 2;
+	to.x_ = 1;
+	to.y_ = 2;
+	to.theta_ = -M_PI;
+	Pose2D motion = RelativePose(from, to);
+	ASSERT_NEAR(1, motion.x_, 1e-9);
+	ASSERT_NEAR(0, motion.y_, 1e-9);
+	ASSERT_NEAR(M_PI / 2, motion.theta_, 1e-9);
+}
+
+int main(int argc, char **argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
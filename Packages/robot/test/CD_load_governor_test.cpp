@@ -0,0 +1,79 @@
+/**
+ * @file CD_load_governor_test.cpp
+ * @brief This file contains the unit tests for the governor that sheds load
+ * in the circle detector
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include "load_governor.h"
+
+GovernorParams TestParams() {
+	GovernorParams params;
+	params.enabled_ = true;
+	params.overload_ = 0.9;
+	params.headroom_ = 0.4;
+	params.smoothing_ = 1;
+	params.hold_frames_ = 2;
+	return params;
+}
+
+TEST(LoadGovernor, StepsDownUnderOverload) {
+	LoadGovernor governor;
+	governor.SetParams(TestParams());
+	ASSERT_EQ(LOAD_NORMAL, governor.Update(0.05, 0.1));
+	ASSERT_EQ(LOAD_SKIP_FRAMES, governor.Update(0.15, 0.1));
+	// The level holds while the load settles
+	ASSERT_EQ(LOAD_SKIP_FRAMES, governor.Update(0.15, 0.1));
+	ASSERT_EQ(LOAD_SKIP_FRAMES, governor.Update(0.15, 0.1));
+	ASSERT_EQ(LOAD_COARSE_RASTER, governor.Update(0.15, 0.1));
+	for (int i = 0; i < 20; ++i) {
+		governor.Update(0.15, 0.1);
+	}
+	ASSERT_EQ(LOAD_CHEAP_BACKEND, governor.Level());
+}
+
+TEST(LoadGovernor, StepsBackWithHeadroom) {
+	LoadGovernor governor;
+	governor.SetParams(TestParams());
+	governor.Update(0.15, 0.1);
+	ASSERT_EQ(LOAD_SKIP_FRAMES, governor.Level());
+	governor.Update(0.02, 0.1);
+	governor.Update(0.02, 0.1);
+	// Two calm frames in a row after the hold
+	ASSERT_EQ(LOAD_SKIP_FRAMES, governor.Update(0.02, 0.1));
+	ASSERT_EQ(LOAD_NORMAL, governor.Update(0.02, 0.1));
+	ASSERT_EQ(LOAD_NORMAL, governor.Update(0.02, 0.1));
+}
+
+TEST(LoadGovernor, KeepsLevelBetweenThresholds) {
+	LoadGovernor governor;
+	governor.SetParams(TestParams());
+	governor.Update(0.15, 0.1);
+	for (int i = 0; i < 10; ++i) {
+		ASSERT_EQ(LOAD_SKIP_FRAMES, governor.Update(0.06, 0.1));
+	}
+}
+
+TEST(LoadGovernor, DisabledOrUnknownPeriod) {
+	LoadGovernor governor;
+	GovernorParams params = TestParams();
+	governor.SetParams(params);
+	ASSERT_EQ(LOAD_NORMAL, governor.Update(0.15, 0));
+	governor.Update(0.15, 0.1);
+	ASSERT_EQ(LOAD_SKIP_FRAMES, governor.Level());
+	params.enabled_ = false;
+	governor.SetParams(params);
+	ASSERT_EQ(LOAD_NORMAL, governor.Level());
+	ASSERT_EQ(LOAD_NORMAL, governor.Update(0.15, 0.1));
+}
+
+int main(int argc, char **argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
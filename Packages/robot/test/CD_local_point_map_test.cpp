@@ -0,0 +1,90 @@
+/**
+ * @file CD_local_point_map_test.cpp
+ * @brief This file contains the unit tests for the rolling map of the last
+ * few laser scans
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "local_point_map.h"
+#include "pose_helpers.h"
+
+TEST(LocalPointMap, MovesPointsWithRobot) {
+	LocalPointMap local_map;
+	local_map.SetCapacity(2);
+	// A point 1 m in front of the robot
+	local_map.Add(std::vector<cv::Point2f>(1, cv::Point2f(0, 1)), MakePose(0, 0, 0));
+
+	// After driving 0.5 m forward it is 0.5 m in front
+	std::vector<cv::Point2f> points;
+	local_map.Collect(MakePose(0.5, 0, 0), points);
+	ASSERT_EQ(1, points.size());
+	ASSERT_NEAR(0, points[0].x, 1e-6);
+	ASSERT_NEAR(0.5, points[0].y, 1e-6);
+
+	// After turning 90 degrees to the left it is 1 m to the right
+	local_map.Collect(MakePose(0, 0, M_PI / 2), points);
+	ASSERT_NEAR(1, points[0].x, 1e-6);
+	ASSERT_NEAR(0, points[0].y, 1e-6);
+}
+
+TEST(LocalPointMap, RotationWithLaserOffset) {
+	LocalPointMap local_map;
+	local_map.SetCapacity(1);
+	local_map.SetLaserOffset(0.15);
+	// A point 1 m in front of the LRF, which is 0.15 m in front of the centre
+	local_map.Add(std::vector<cv::Point2f>(1, cv::Point2f(0, 1)), MakePose(0, 0, 0));
+
+	// Turning 90 degrees to the left in place swings the LRF to the left of
+	// where it was, so the point ends up behind it
+	std::vector<cv::Point2f> points;
+	local_map.Collect(MakePose(0, 0, M_PI / 2), points);
+	ASSERT_EQ(1, points.size());
+	ASSERT_NEAR(1.15, points[0].x, 1e-6);
+	ASSERT_NEAR(-0.15, points[0].y, 1e-6);
+}
+
+TEST(LocalPointMap, KeepsLastScans) {
+	LocalPointMap local_map;
+	local_map.SetCapacity(2);
+	for (int i = 1; i <= 3; ++i) {
+		local_map.Add(std::vector<cv::Point2f>(i, cv::Point2f(0, 1)), MakePose(0, 0, 0));
+	}
+
+	// The first scan with a single point was overwritten
+	std::vector<cv::Point2f> points;
+	local_map.Collect(MakePose(0, 0, 0), points);
+	ASSERT_EQ(5, points.size());
+}
+
+TEST(LocalPointMap, CapacityChangeClears) {
+	LocalPointMap local_map;
+	local_map.SetCapacity(2);
+	local_map.Add(std::vector<cv::Point2f>(1, cv::Point2f(0, 1)), MakePose(0, 0, 0));
+	local_map.SetCapacity(3);
+
+	std::vector<cv::Point2f> points;
+	local_map.Collect(MakePose(0, 0, 0), points);
+	ASSERT_EQ(0, points.size());
+}
+
+TEST(LocalPointMap, NoCapacity) {
+	LocalPointMap local_map;
+	local_map.Add(std::vector<cv::Point2f>(1, cv::Point2f(0, 1)), MakePose(0, 0, 0));
+
+	std::vector<cv::Point2f> points;
+	local_map.Collect(MakePose(0, 0, 0), points);
+	ASSERT_EQ(0, points.size());
+}
+
+int main(int argc, char **argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
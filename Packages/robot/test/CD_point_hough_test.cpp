@@ -0,0 +1,129 @@
+/**
+ * @file CD_point_hough_test.cpp
+ * @brief This file contains the unit tests for the sparse point-voting Hough
+ * transform
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "point_hough.h"
+#include "detect_helpers.h"
+
+// Casts 720 beams over 240 degrees from the origin against a wall in front,
+// a wall to the right and optionally a circle, in screen coordinates
+std::vector<cv::Point2f> SimulateScan(cv::Point2f origin, bool with_circle,
+                                      cv::Point2f centre, float radius) {
+	std::vector<cv::Point2f> points;
+	for (int i = 0; i < 720; ++i) {
+		double angle = (-120 + i * 240.0 / 720) * M_PI / 180;
+		double dx = sin(angle), dy = -cos(angle);
+		double range = 1e9;
+
+		// Wall 150 pixels in front
+		if (dy < 0) {
+			range = std::min(range, -150 / dy);
+		}
+		// Wall 120 pixels to the right
+		if (dx > 0) {
+			range = std::min(range, 120 / dx);
+		}
+		if (with_circle) {
+			double fx = origin.x - centre.x, fy = origin.y - centre.y;
+			double b = fx * dx + fy * dy;
+			double c = fx * fx + fy * fy - radius * radius;
+			if (b * b - c >= 0 && -b - sqrt(b * b - c) > 0) {
+				range = std::min(range, -b - sqrt(b * b - c));
+			}
+		}
+		if (range < 200) {
+			points.push_back(cv::Point2f(origin.x + range * dx, origin.y + range * dy));
+		}
+	}
+	return points;
+}
+
+HoughParams TestParams() {
+	HoughParams params;
+	params.dp_ = 1;
+	params.min_dist_ = 1000;
+	params.threshold_1_ = 30;
+	params.threshold_2_ = 15;
+	params.min_radius_ = 5;
+	params.max_radius_ = 30;
+	return params;
+}
+
+TEST(PointHough, FindsCircle) {
+	cv::Point2f origin(500, 500);
+	cv::Point2f centre(470, 420);
+	std::vector<cv::Point2f> points = SimulateScan(origin, true, centre, 15);
+	std::vector<cv::Vec3f> circles;
+	PointHough point_hough;
+	point_hough.Detect(points, origin, TestParams(), circles);
+	ASSERT_EQ(1, circles.size());
+	ASSERT_NEAR(centre.x, circles[0][0], 1.5);
+	ASSERT_NEAR(centre.y, circles[0][1], 1.5);
+	ASSERT_NEAR(15, circles[0][2], 1.5);
+}
+
+TEST(PointHough, IgnoresWalls) {
+	cv::Point2f origin(500, 500);
+	std::vector<cv::Point2f> points = SimulateScan(origin, false, origin, 0);
+	std::vector<cv::Vec3f> circles;
+	PointHough point_hough;
+	point_hough.Detect(points, origin, TestParams(), circles);
+	ASSERT_EQ(0, circles.size());
+}
+
+TEST(PointHough, MinDistKeepsSeparateCircles) {
+	cv::Point2f origin(500, 500);
+	std::vector<cv::Point2f> points = SimulateScan(origin, true, cv::Point2f(450, 420), 15);
+	std::vector<cv::Point2f> second = SimulateScan(origin, true, cv::Point2f(540, 400), 15);
+	// Keep the second circle only from the second scan
+	for (size_t i = 0; i < second.size(); ++i) {
+		if (std::hypot(second[i].x - 540, second[i].y - 400) < 16) {
+			points.push_back(second[i]);
+		}
+	}
+	HoughParams params = TestParams();
+	params.min_dist_ = 20;
+	std::vector<cv::Vec3f> circles;
+	PointHough point_hough;
+	point_hough.Detect(points, origin, params, circles);
+	ASSERT_EQ(2, circles.size());
+}
+
+TEST(PointHough, DeadlineTruncates) {
+	cv::Point2f origin(500, 500);
+	std::vector<cv::Point2f> points = SimulateScan(origin, true, cv::Point2f(470, 420), 15);
+	std::vector<cv::Vec3f> circles;
+	PointHough point_hough;
+	ASSERT_TRUE(point_hough.Detect(points, origin, TestParams(), circles, Deadline(10)));
+	ASSERT_EQ(1, circles.size());
+
+	Deadline deadline(1e-6);
+	while (!deadline.Expired()) {
+	}
+	ASSERT_FALSE(point_hough.Detect(points, origin, TestParams(), circles, deadline));
+	ASSERT_EQ(0, circles.size());
+}
+
+TEST(PointHough, EmptyInput) {
+	std::vector<cv::Point2f> points;
+	std::vector<cv::Vec3f> circles;
+	PointHough point_hough;
+	point_hough.Detect(points, cv::Point2f(500, 500), TestParams(), circles);
+	ASSERT_EQ(0, circles.size());
+}
+
+int main(int argc, char **argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,146 @@
+/**
+ * @file CD_polar_matcher_test.cpp
+ * @brief This file contains the unit tests for the polar template matcher of
+ * the circle detector
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "polar_matcher.h"
+
+const double angle_min = -120 * M_PI / 180;
+const double angle_increment = 240 * M_PI / 180 / 720;
+
+// Range of a beam to a segment from (x1, y1) to (x2, y2), or 5 if missed
+double HitSegment(double angle, double x1, double y1, double x2, double y2) {
+	double dx = cos(angle), dy = sin(angle);
+	double ex = x2 - x1, ey = y2 - y1;
+	double denominator = dx * ey - dy * ex;
+	if (fabs(denominator) < 1e-12) {
+		return 5;
+	}
+	double t = (x1 * ey - y1 * ex) / denominator;
+	double u = (x1 * dy - y1 * dx) / denominator;
+	return (t > 0 && u >= 0 && u <= 1) ? t : 5;
+}
+
+// Range of a beam to a circle, or 5 if missed
+double HitCircle(double angle, double cx, double cy, double radius) {
+	double dx = cos(angle), dy = sin(angle);
+	double b = cx * dx + cy * dy;
+	double c = cx * cx + cy * cy - radius * radius;
+	if (b * b - c < 0 || b - sqrt(b * b - c) <= 0) {
+		return 5;
+	}
+	return b - sqrt(b * b - c);
+}
+
+// A corridor with a wall in front, a box and optionally circles
+std::vector<float> SimulateScan(const std::vector<cv::Vec3f>& circles) {
+	std::vector<float> ranges;
+	for (int i = 0; i < 720; ++i) {
+		double angle = angle_min + i * angle_increment;
+		double range = 5;
+		range = std::min(range, HitSegment(angle, -1, -0.8, 3, -0.8));
+		range = std::min(range, HitSegment(angle, -1, 0.8, 3, 0.8));
+		range = std::min(range, HitSegment(angle, 1.8, -0.8, 1.8, 0.8));
+		range = std::min(range, HitSegment(angle, 0.8, -0.5, 1.0, -0.5));
+		range = std::min(range, HitSegment(angle, 0.8, -0.5, 0.8, -0.3));
+		range = std::min(range, HitSegment(angle, 0.8, -0.3, 1.0, -0.3));
+		for (size_t j = 0; j < circles.size(); ++j) {
+			range = std::min(range, HitCircle(angle, circles[j][0], circles[j][1], circles[j][2]));
+		}
+		ranges.push_back(range);
+	}
+	return ranges;
+}
+
+TEST(PolarMatcher, FindsCircle) {
+	std::vector<cv::Vec3f> circles(1, cv::Vec3f(1.0, 0.3, 0.15));
+	std::vector<float> ranges = SimulateScan(circles);
+	std::vector<PolarMatch> matches;
+	PolarMatcher polar_matcher;
+	polar_matcher.Match(ranges, angle_increment, 0.1, 0.3, 2, 0.01, matches);
+	ASSERT_EQ(1, matches.size());
+
+	double angle = angle_min + matches[0].index_ * angle_increment;
+	ASSERT_NEAR(1.0, matches[0].distance_ * cos(angle), 0.01);
+	ASSERT_NEAR(0.3, matches[0].distance_ * sin(angle), 0.01);
+	ASSERT_NEAR(0.15, matches[0].radius_, 0.01);
+}
+
+TEST(PolarMatcher, IgnoresWallsAndBoxes) {
+	std::vector<cv::Vec3f> circles;
+	std::vector<float> ranges = SimulateScan(circles);
+	std::vector<PolarMatch> matches;
+	PolarMatcher polar_matcher;
+	polar_matcher.Match(ranges, angle_increment, 0.1, 0.3, 2, 0.01, matches);
+	ASSERT_EQ(0, matches.size());
+}
+
+TEST(PolarMatcher, FindsSeparateCircles) {
+	std::vector<cv::Vec3f> circles;
+	circles.push_back(cv::Vec3f(1.0, 0.3, 0.15));
+	circles.push_back(cv::Vec3f(0.5, -0.1, 0.12));
+	std::vector<float> ranges = SimulateScan(circles);
+	std::vector<PolarMatch> matches;
+	PolarMatcher polar_matcher;
+	polar_matcher.Match(ranges, angle_increment, 0.1, 0.3, 2, 0.01, matches);
+	ASSERT_EQ(2, matches.size());
+}
+
+TEST(PolarMatcher, DeadlineTruncates) {
+	std::vector<cv::Vec3f> circles(1, cv::Vec3f(1.0, 0.3, 0.15));
+	std::vector<float> ranges = SimulateScan(circles);
+	std::vector<PolarMatch> matches;
+	PolarMatcher polar_matcher;
+	ASSERT_TRUE(polar_matcher.Match(ranges, angle_increment, 0.1, 0.3, 2, 0.01, matches,
+	                                Deadline(10)));
+	ASSERT_EQ(1, matches.size());
+
+	Deadline deadline(1e-6);
+	while (!deadline.Expired()) {
+	}
+	ASSERT_FALSE(polar_matcher.Match(ranges, angle_increment, 0.1, 0.3, 2, 0.01, matches,
+	                                 deadline));
+	ASSERT_EQ(0, matches.size());
+}
+
+TEST(PolarMatcher, NarrowerSearches) {
+	std::vector<cv::Vec3f> circles(1, cv::Vec3f(1.0, 0.3, 0.15));
+	std::vector<float> ranges = SimulateScan(circles);
+	std::vector<PolarMatch> matches;
+	PolarMatcher polar_matcher;
+	polar_matcher.Match(ranges, angle_increment, 0.1, 0.3, 2, 0.01, matches);
+	ASSERT_EQ(1, matches.size());
+
+	// A closer band and the radius range of a tracked circle use a part of
+	// the same templates
+	polar_matcher.Match(ranges, angle_increment, 0.1, 0.3, 0.8, 0.01, matches);
+	ASSERT_EQ(0, matches.size());
+	polar_matcher.Match(ranges, angle_increment, 0.13, 0.17, 2, 0.01, matches);
+	ASSERT_EQ(1, matches.size());
+	ASSERT_NEAR(0.15, matches[0].radius_, 0.01);
+	polar_matcher.Match(ranges, angle_increment, 0.25, 0.3, 2, 0.01, matches);
+	ASSERT_EQ(0, matches.size());
+}
+
+TEST(PolarMatcher, ShortScan) {
+	std::vector<float> ranges(3, 1);
+	std::vector<PolarMatch> matches;
+	PolarMatcher polar_matcher;
+	polar_matcher.Match(ranges, angle_increment, 0.1, 0.3, 2, 0.01, matches);
+	ASSERT_EQ(0, matches.size());
+}
+
+int main(int argc, char **argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,114 @@
+/**
+ * @file CD_pose_helpers_test.cpp
+ * @brief This file contains the unit tests for the helpers to work with
+ * odometry poses
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include "pose_helpers.h"
+
+TEST(PoseHelpers, LaserMotion) {
+	// A turn in place swings the LRF in front of the centre round with it
+	Pose2D motion = LaserMotion(MakePose(0, 0, M_PI / 2), 0.15);
+	ASSERT_NEAR(-0.15, motion.x_, 1e-9);
+	ASSERT_NEAR(0.15, motion.y_, 1e-9);
+	ASSERT_NEAR(M_PI / 2, motion.theta_, 1e-9);
+
+	// Driving straight moves it like the centre
+	motion = LaserMotion(MakePose(0.3, 0, 0), 0.15);
+	ASSERT_NEAR(0.3, motion.x_, 1e-9);
+	ASSERT_NEAR(0, motion.y_, 1e-9);
+}
+
+TEST(PoseHelpers, ComposePose) {
+	// Undoes RelativePose
+	Pose2D from = MakePose(1, 2, 0.5);
+	Pose2D to = MakePose(-0.5, 3, -2.8);
+	Pose2D pose = ComposePose(from, RelativePose(from, to));
+	ASSERT_NEAR(to.x_, pose.x_, 1e-9);
+	ASSERT_NEAR(to.y_, pose.y_, 1e-9);
+	ASSERT_NEAR(to.theta_, pose.theta_, 1e-9);
+}
+
+TEST(PoseHelpers, MapFixPlusOdometry) {
+	// Localised at (2, 1) facing up in the map, while the odometry had the
+	// robot at (1, 0) facing along x
+	Pose2D map_fix = MakePose(2, 1, M_PI / 2);
+	Pose2D map_fix_odom = MakePose(1, 0, 0);
+
+	// Half a metre forward and a quarter turn left in the odometry
+	Pose2D odom = MakePose(1.5, 0, M_PI / 2);
+	Pose2D pose = ComposePose(map_fix, RelativePose(map_fix_odom, odom));
+	ASSERT_NEAR(2, pose.x_, 1e-9);
+	ASSERT_NEAR(1.5, pose.y_, 1e-9);
+	ASSERT_NEAR(M_PI, std::fabs(pose.theta_), 1e-9);
+
+	// A goal in the map is the same distance ahead in the odometry
+	Pose2D goal = MakePose(2, 3, 0);
+	Pose2D odom_goal = ComposePose(odom, RelativePose(pose, goal));
+	ASSERT_NEAR(3, odom_goal.x_, 1e-9);
+	ASSERT_NEAR(0, odom_goal.y_, 1e-9);
+}
+
+TEST(PoseHistory, InterpolatesBetweenPoses) {
+	PoseHistory history(2);
+	history.Add(10, MakePose(0, 0, 0));
+	history.Add(10.5, MakePose(1, 0.5, 0.4));
+
+	Pose2D pose;
+	ASSERT_TRUE(history.PoseAt(10.25, pose));
+	ASSERT_NEAR(0.5, pose.x_, 1e-9);
+	ASSERT_NEAR(0.25, pose.y_, 1e-9);
+	ASSERT_NEAR(0.2, pose.theta_, 1e-9);
+
+	// After the newest pose the robot is taken to be there
+	ASSERT_TRUE(history.PoseAt(11, pose));
+	ASSERT_NEAR(1, pose.x_, 1e-9);
+
+	// Before the oldest pose nothing is known
+	pose = MakePose(7, 7, 0);
+	ASSERT_FALSE(history.PoseAt(9, pose));
+	ASSERT_EQ(7, pose.x_);
+}
+
+TEST(PoseHistory, InterpolatesAcrossPi) {
+	PoseHistory history(2);
+	history.Add(0, MakePose(0, 0, M_PI - 0.1));
+	history.Add(1, MakePose(0, 0, -M_PI + 0.1));
+
+	// The short way round is through pi, not through 0
+	Pose2D pose;
+	ASSERT_TRUE(history.PoseAt(0.5, pose));
+	ASSERT_NEAR(M_PI, std::fabs(pose.theta_), 1e-9);
+}
+
+TEST(PoseHistory, ForgetsOldPoses) {
+	PoseHistory history(1);
+	Pose2D pose;
+	ASSERT_FALSE(history.PoseAt(0, pose));
+
+	history.Add(0, MakePose(0, 0, 0));
+	history.Add(1, MakePose(1, 0, 0));
+	history.Add(2, MakePose(2, 0, 0));
+	ASSERT_FALSE(history.PoseAt(0.5, pose));
+	ASSERT_TRUE(history.PoseAt(1.5, pose));
+	ASSERT_NEAR(1.5, pose.x_, 1e-9);
+
+	// A clock that jumps back starts a new history
+	history.Add(0, MakePose(5, 0, 0));
+	ASSERT_FALSE(history.PoseAt(-0.5, pose));
+	ASSERT_TRUE(history.PoseAt(0, pose));
+	ASSERT_NEAR(5, pose.x_, 1e-9);
+}
+
+int main(int argc, char** argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
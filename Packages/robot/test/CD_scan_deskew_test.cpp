@@ -0,0 +1,110 @@
+/**
+ * @file CD_scan_deskew_test.cpp
+ * @brief This file contains the unit tests for the correction of the motion
+ * of the robot during a laser sweep
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "scan_deskew.h"
+
+const double angle_min = -120 * M_PI / 180;
+const double angle_increment = 240 * M_PI / 180 / 720;
+const double time_increment = 0.1 / 1080;
+
+// A wall one metre from the LRF at the end of the sweep, its normal at
+// wall_angle, seen by a robot moving with the given twist during the sweep.
+// The LRF sits laser_offset in front of the centre the robot turns around
+sensor_msgs::LaserScan SimulateScan(double linear_velocity, double angular_velocity,
+                                    double laser_offset = 0, double wall_angle = 0) {
+	sensor_msgs::LaserScan scan;
+	scan.angle_min = angle_min;
+	scan.angle_increment = angle_increment;
+	scan.time_increment = time_increment;
+	scan.scan_time = 0.1;
+	scan.range_min = 0.02;
+	scan.range_max = 5;
+	for (int i = 0; i < 720; ++i) {
+		double dt = (719 - i) * time_increment;
+		double direction = angle_min + i * angle_increment - angular_velocity * dt;
+		// Position of the LRF against where it is at the end of the sweep
+		double laser_x = -linear_velocity * dt - laser_offset * (1 - cos(angular_velocity * dt));
+		double laser_y = -laser_offset * sin(angular_velocity * dt);
+		double facing = cos(direction - wall_angle);
+		double range = 5;
+		if (facing > 0.3) {
+			range = (1 - laser_x * cos(wall_angle) - laser_y * sin(wall_angle)) / facing;
+		}
+		scan.ranges.push_back(range);
+	}
+	return scan;
+}
+
+// Largest difference to the wall seen from the end of the sweep, within 45
+// degrees of its normal
+double WallError(const std::vector<float>& ranges, double wall_angle = 0) {
+	double error = 0;
+	for (int i = 0; i < 720; ++i) {
+		double angle = angle_min + i * angle_increment - wall_angle;
+		if (fabs(angle) < M_PI / 4) {
+			error = std::max(error, fabs(ranges[i] - 1 / cos(angle)));
+		}
+	}
+	return error;
+}
+
+TEST(ScanDeskewer, Rotation) {
+	sensor_msgs::LaserScan scan = SimulateScan(0, 1);
+	ASSERT_GT(WallError(scan.ranges), 0.05);
+	std::vector<float> ranges;
+	ScanDeskewer deskewer;
+	ASSERT_TRUE(deskewer.Deskew(scan, 0, 1, ranges));
+	ASSERT_LT(WallError(ranges), 0.01);
+}
+
+TEST(ScanDeskewer, Translation) {
+	sensor_msgs::LaserScan scan = SimulateScan(0.8, 0);
+	ASSERT_GT(WallError(scan.ranges), 0.05);
+	std::vector<float> ranges;
+	ScanDeskewer deskewer;
+	ASSERT_TRUE(deskewer.Deskew(scan, 0.8, 0, ranges));
+	ASSERT_LT(WallError(ranges), 0.01);
+}
+
+TEST(ScanDeskewer, RotationWithLaserOffset) {
+	// The LRF swings sideways in a turn, which shows on a wall to the side
+	sensor_msgs::LaserScan scan = SimulateScan(0, 2, 0.15, M_PI / 2);
+	std::vector<float> ranges;
+	ScanDeskewer deskewer;
+	ASSERT_TRUE(deskewer.Deskew(scan, 0, 2, ranges));
+	double without_offset = WallError(ranges, M_PI / 2);
+	deskewer.SetParams(0.15);
+	ASSERT_TRUE(deskewer.Deskew(scan, 0, 2, ranges));
+	ASSERT_GT(without_offset, 0.008);
+	ASSERT_LT(WallError(ranges, M_PI / 2), without_offset / 2);
+}
+
+TEST(ScanDeskewer, StandingStillOrNoTiming) {
+	sensor_msgs::LaserScan scan = SimulateScan(0, 0);
+	std::vector<float> ranges;
+	ScanDeskewer deskewer;
+	ASSERT_FALSE(deskewer.Deskew(scan, 0, 0, ranges));
+	ASSERT_EQ(scan.ranges, ranges);
+
+	scan.time_increment = 0;
+	scan.scan_time = 0;
+	ASSERT_FALSE(deskewer.Deskew(scan, 0.5, 1, ranges));
+	ASSERT_EQ(scan.ranges, ranges);
+}
+
+int main(int argc, char **argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
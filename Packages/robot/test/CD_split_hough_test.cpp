@@ -0,0 +1,115 @@
+/**
+ * @file CD_split_hough_test.cpp
+ * @brief This file contains the unit tests for splitting the Hough transform
+ * into parallel jobs
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "split_hough.h"
+#include "detect_helpers.h"
+
+HoughParams TestParams() {
+	HoughParams params;
+	params.dp_ = 1;
+	params.min_dist_ = 1000;
+	params.threshold_1_ = 30;
+	params.threshold_2_ = 15;
+	params.min_radius_ = 15;
+	params.max_radius_ = 30;
+	return params;
+}
+
+TEST(SplitHough, SingleJob) {
+	SplitParams split;
+	split.radius_splits_ = 1;
+	split.tiles_ = 1;
+	std::vector<HoughJob> jobs;
+	cv::Rect window(10, 20, 300, 200);
+	PlanHoughJobs(window, TestParams(), split, jobs);
+	ASSERT_EQ(1, jobs.size());
+	ASSERT_EQ(window, jobs[0].core_);
+	ASSERT_EQ(window, jobs[0].tile_);
+	ASSERT_EQ(15, jobs[0].min_radius_);
+	ASSERT_EQ(30, jobs[0].max_radius_);
+}
+
+TEST(SplitHough, RadiusPartsCoverRange) {
+	SplitParams split;
+	split.radius_splits_ = 3;
+	split.tiles_ = 1;
+	std::vector<HoughJob> jobs;
+	PlanHoughJobs(cv::Rect(0, 0, 300, 300), TestParams(), split, jobs);
+	ASSERT_EQ(3, jobs.size());
+	ASSERT_EQ(15, jobs[0].min_radius_);
+	ASSERT_EQ(30, jobs[2].max_radius_);
+	for (size_t i = 1; i < jobs.size(); ++i) {
+		// Neighbouring parts overlap by a pixel
+		ASSERT_EQ(jobs[i - 1].max_radius_, jobs[i].min_radius_);
+		ASSERT_LE(jobs[i].min_radius_, jobs[i].max_radius_);
+	}
+}
+
+TEST(SplitHough, TilesCoverWindow) {
+	SplitParams split;
+	split.radius_splits_ = 1;
+	split.tiles_ = 3;
+	std::vector<HoughJob> jobs;
+	cv::Rect window(5, 7, 301, 250);
+	HoughParams params = TestParams();
+	PlanHoughJobs(window, params, split, jobs);
+	ASSERT_EQ(9, jobs.size());
+
+	int area = 0;
+	for (size_t i = 0; i < jobs.size(); ++i) {
+		area += jobs[i].core_.area();
+		for (size_t j = 0; j < i; ++j) {
+			ASSERT_EQ(0, (jobs[i].core_ & jobs[j].core_).area());
+		}
+		// The tile holds every edge point within the largest radius of the core
+		cv::Rect grown(jobs[i].core_.x - params.max_radius_, jobs[i].core_.y - params.max_radius_,
+		               jobs[i].core_.width + 2 * params.max_radius_,
+		               jobs[i].core_.height + 2 * params.max_radius_);
+		grown &= window;
+		ASSERT_EQ(grown, grown & jobs[i].tile_);
+		ASSERT_EQ(jobs[i].tile_, jobs[i].tile_ & window);
+	}
+	ASSERT_EQ(window.area(), area);
+}
+
+TEST(SplitHough, MergeKeepsBestSupported) {
+	cv::Mat image(200, 200, CV_8UC1, cv::Scalar(0));
+	// A bright ring around (100, 100) with radius 20
+	for (int i = 0; i < 360; ++i) {
+		double angle = i * M_PI / 180;
+		image.at<uchar>(cvRound(100 + 20 * sin(angle)), cvRound(100 + 20 * cos(angle))) = 255;
+	}
+	ASSERT_GT(RingSupport(image, cv::Vec3f(100, 100, 20)), 200);
+	ASSERT_LT(RingSupport(image, cv::Vec3f(60, 60, 20)), 50);
+
+	std::vector<std::vector<cv::Vec3f> > results(2);
+	results[0].push_back(cv::Vec3f(60, 60, 20));
+	results[1].push_back(cv::Vec3f(101, 100, 20));
+	results[1].push_back(cv::Vec3f(100, 100, 20));
+	std::vector<cv::Vec3f> circles;
+	MergeCircles(image, results, 10, circles);
+	ASSERT_EQ(2, circles.size());
+	ASSERT_FLOAT_EQ(100, circles[0][0]);
+	ASSERT_FLOAT_EQ(60, circles[1][0]);
+
+	MergeCircles(image, results, 1000, circles);
+	ASSERT_EQ(1, circles.size());
+	ASSERT_FLOAT_EQ(100, circles[0][0]);
+}
+
+int main(int argc, char **argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,79 @@
+/**
+ * @file CD_spsc_queue_test.cpp
+ * @brief This file contains the unit tests for the lock-free queue between
+ * the stages of the circle detector
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "spsc_queue.h"
+
+TEST(SpscQueue, FirstInFirstOut) {
+	SpscQueue<int> queue(3);
+	ASSERT_EQ(3, queue.Capacity());
+	ASSERT_TRUE(queue.TryPush(1));
+	ASSERT_TRUE(queue.TryPush(2));
+	int value = 0;
+	ASSERT_TRUE(queue.TryPop(value));
+	ASSERT_EQ(1, value);
+	ASSERT_TRUE(queue.TryPush(3));
+	ASSERT_TRUE(queue.TryPop(value));
+	ASSERT_EQ(2, value);
+	ASSERT_TRUE(queue.TryPop(value));
+	ASSERT_EQ(3, value);
+}
+
+TEST(SpscQueue, FullAndEmpty) {
+	SpscQueue<int> queue(2);
+	int value = -1;
+	ASSERT_FALSE(queue.TryPop(value));
+	ASSERT_EQ(-1, value);
+	ASSERT_TRUE(queue.TryPush(1));
+	ASSERT_TRUE(queue.TryPush(2));
+	ASSERT_FALSE(queue.TryPush(3));
+	ASSERT_TRUE(queue.TryPop(value));
+	ASSERT_TRUE(queue.TryPush(3));
+	ASSERT_TRUE(queue.TryPop(value));
+	ASSERT_TRUE(queue.TryPop(value));
+	ASSERT_EQ(3, value);
+	ASSERT_FALSE(queue.TryPop(value));
+}
+
+void Produce(SpscQueue<int>* queue, int count) {
+	for (int i = 0; i < count; ++i) {
+		while (!queue->TryPush(i)) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+TEST(SpscQueue, TwoThreadsKeepOrder) {
+	const int count = 100000;
+	SpscQueue<int> queue(2);
+	std::thread producer(Produce, &queue, count);
+	std::vector<int> received;
+	while (static_cast<int>(received.size()) < count) {
+		int value;
+		if (queue.TryPop(value)) {
+			received.push_back(value);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+	for (int i = 0; i < count; ++i) {
+		ASSERT_EQ(i, received[i]);
+	}
+}
+
+int main(int argc, char **argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
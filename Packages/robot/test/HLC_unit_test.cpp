@@ -11,6 +11,8 @@
 
 #include <gtest/gtest.h>
 #include <ros/ros.h>
+#include <algorithm>
+#include <cmath>
 #include "high_level_control.h"
 #include "move_helpers.h"
 
@@ -173,53 +175,76 @@ TEST(HlcCanHit, NoneCase) {
 TEST(HlcCanHit, YesCase) {
 	HighLevelControl high_level_control;
 	high_level_control.set_turn_type(RIGHT);
-	std::vector<float> right_vector;
+	// A circle 0.5 m ahead seen over 30 degrees, nothing else near
+	std::vector<float> circle_vector;
 	int i;
-	for (i = 0; i < 380; i++) {
-		right_vector.push_back(0.1);
+	for (i = 0; i < 315; i++) {
+		circle_vector.push_back(5);
 	}
 
-	for (i = 380; i < 720; i++) {
-		right_vector.push_back(5);
+	for (i = 315; i < 405; i++) {
+		circle_vector.push_back(0.35);
 	}
-	ASSERT_TRUE(high_level_control.CanHit(0, 0.5, right_vector));
+
+	for (i = 405; i < 720; i++) {
+		circle_vector.push_back(5);
+	}
+	ASSERT_TRUE(high_level_control.CanHit(0, 0.5, circle_vector));
 
 	high_level_control.set_turn_type(LEFT);
-	std::vector<float> left_vector;
-	for (i = 0; i < 340; i++) {
-		left_vector.push_back(5);
+	ASSERT_TRUE(high_level_control.CanHit(0, 0.5, circle_vector));
+
+	// Further away than the old two beam check allowed
+	for (i = 315; i < 405; i++) {
+		circle_vector[i] = i < 351 || i >= 369 ? 5 : 1.25;
 	}
+	ASSERT_TRUE(high_level_control.CanHit(0, 1.4, circle_vector));
+}
 
-	for (i = 340; i < 720; i++) {
-		left_vector.push_back(0.1);
+TEST(HlcCanHit, BlockedCase) {
+	HighLevelControl high_level_control;
+	high_level_control.set_turn_type(RIGHT);
+	std::vector<float> circle_vector;
+	int i;
+	for (i = 0; i < 315; i++) {
+		circle_vector.push_back(5);
 	}
-	ASSERT_TRUE(high_level_control.CanHit(0, 0.5, left_vector));
+
+	for (i = 315; i < 405; i++) {
+		circle_vector.push_back(0.35);
+	}
+
+	for (i = 405; i < 720; i++) {
+		circle_vector.push_back(5);
+	}
+	// An obstacle 0.3 m away and 30 degrees to the right is in the way of
+	// the robot although no beam towards the circle sees it
+	for (i = 266; i < 272; i++) {
+		circle_vector[i] = 0.3;
+	}
+	ASSERT_FALSE(high_level_control.CanHit(0, 0.5, circle_vector));
 }
 
 TEST(HlcCanHit, ToFarCase) {
 	HighLevelControl high_level_control;
 	high_level_control.set_turn_type(RIGHT);
-	std::vector<float> right_vector;
+	std::vector<float> circle_vector;
 	int i;
-	for (i = 0; i < 380; i++) {
-		right_vector.push_back(0.1);
+	for (i = 0; i < 350; i++) {
+		circle_vector.push_back(5);
 	}
 
-	for (i = 380; i < 720; i++) {
-		right_vector.push_back(5);
+	for (i = 350; i < 370; i++) {
+		circle_vector.push_back(2.45);
 	}
-	ASSERT_FALSE(high_level_control.CanHit(0, 1.1, right_vector));
 
-	high_level_control.set_turn_type(LEFT);
-	std::vector<float> left_vector;
-	for (i = 0; i < 340; i++) {
-		left_vector.push_back(5);
+	for (i = 370; i < 720; i++) {
+		circle_vector.push_back(5);
 	}
+	ASSERT_FALSE(high_level_control.CanHit(0, 2.6, circle_vector));
 
-	for (i = 340; i < 720; i++) {
-		left_vector.push_back(0.1);
-	}
-	ASSERT_FALSE(high_level_control.CanHit(0, 1.1, left_vector));
+	high_level_control.set_turn_type(LEFT);
+	ASSERT_FALSE(high_level_control.CanHit(0, 2.6, circle_vector));
 }
 
 TEST(HlcCanHit, BigXCase) {
@@ -274,6 +299,25 @@ TEST(HlcCanHit, CornerCaseCase) {
 	ASSERT_FALSE(high_level_control.CanHit(0, 0.5, left_vector));
 }
 
+TEST(HlcCanHit, ConvexCornerCase) {
+	HighLevelControl high_level_control;
+	// A corner 0.8 m ahead with its walls going away at 45 degrees on both
+	// sides. The way to it is free, but the walls go on behind the circle
+	// a Hough transform finds in it
+	std::vector<float> corner_vector;
+	for (int i = 0; i < 720; i++) {
+		double angle = (i / 720.0 * 240 - 30) / 180 * M_PI;
+		// Beams to the right meet the right wall, the others the left one
+		double facing = std::sin(angle) - std::fabs(std::cos(angle));
+		corner_vector.push_back(facing > 0 ? std::min(5.0, 0.8 / facing) : 5);
+	}
+
+	high_level_control.set_turn_type(RIGHT);
+	ASSERT_FALSE(high_level_control.CanHit(0, 1, corner_vector));
+	high_level_control.set_turn_type(LEFT);
+	ASSERT_FALSE(high_level_control.CanHit(0, 1, corner_vector));
+}
+
 TEST(HlcCanHit, InsideCase) {
 	HighLevelControl high_level_control;
 	high_level_control.set_turn_type(RIGHT);
@@ -300,6 +344,134 @@ TEST(HlcCanHit, InsideCase) {
 	ASSERT_FALSE(high_level_control.CanHit(0, 0.5, left_vector));
 }
 
+TEST(HlcChooseCircle, CandidatesCase) {
+	HighLevelControl high_level_control;
+	high_level_control.set_turn_type(RIGHT);
+	// Only the circle in front is seen
+	std::vector<float> right_vector;
+	int i;
+	for (i = 0; i < 315; i++) {
+		right_vector.push_back(5);
+	}
+
+	for (i = 315; i < 405; i++) {
+		right_vector.push_back(0.35);
+	}
+
+	for (i = 405; i < 720; i++) {
+		right_vector.push_back(5);
+	}
+
+	// Two circles in the scan, so none is detected on its own
+	robot::circle_detect_msg msg;
+	msg.circle_x = -10;
+	msg.circle_y = -10;
+	ASSERT_FALSE(high_level_control.ChooseCircle(msg, right_vector));
+
+	// A corner too far to the side and the circle in front
+	robot::circle_candidate corner, circle;
+	corner.x = 1;
+	corner.y = 0.5;
+	corner.confidence = 0.9;
+	circle.x = 0;
+	circle.y = 0.5;
+	circle.confidence = 0.6;
+	msg.candidates.push_back(corner);
+	ASSERT_FALSE(high_level_control.ChooseCircle(msg, right_vector));
+	msg.candidates.push_back(circle);
+	ASSERT_TRUE(high_level_control.ChooseCircle(msg, right_vector));
+}
+
+TEST(HlcNeedsDetections, TurnTypeCase) {
+	HighLevelControl high_level_control;
+	// No circle can be hit before a wall is followed
+	ASSERT_FALSE(high_level_control.NeedsDetections());
+	high_level_control.set_turn_type(LEFT);
+	ASSERT_TRUE(high_level_control.NeedsDetections());
+}
+
+TEST(HlcFollowCircle, MissCase) {
+	HighLevelControl high_level_control;
+	std::vector<float> ranges(720, 5);
+	robot::circle_detect_msg msg;
+	msg.circle_x = 0;
+	msg.circle_y = 1;
+	high_level_control.ChooseCircle(msg, ranges);
+
+	// A frame with only a decoy keeps the chosen circle
+	msg.circle_x = 1;
+	msg.circle_y = 0.5;
+	high_level_control.FollowCircle(msg);
+	ASSERT_NEAR(0, high_level_control.get_circle_x(), 1e-6);
+	ASSERT_NEAR(1, high_level_control.get_circle_y(), 1e-6);
+
+	// So does a frame without any circle
+	msg.circle_x = -10;
+	msg.circle_y = -10;
+	high_level_control.FollowCircle(msg);
+	ASSERT_NEAR(0, high_level_control.get_circle_x(), 1e-6);
+	ASSERT_NEAR(1, high_level_control.get_circle_y(), 1e-6);
+
+	// A candidate close to it is followed
+	robot::circle_candidate circle;
+	circle.x = 0.1;
+	circle.y = 1;
+	circle.confidence = 0.5;
+	msg.candidates.push_back(circle);
+	high_level_control.FollowCircle(msg);
+	ASSERT_NEAR(0.1, high_level_control.get_circle_x(), 1e-6);
+	ASSERT_NEAR(1, high_level_control.get_circle_y(), 1e-6);
+
+	// Only missing it many times in a row loses it
+	msg.candidates.clear();
+	for (int i = 0; i < 5; ++i) {
+		high_level_control.FollowCircle(msg);
+	}
+	ASSERT_NEAR(0.1, high_level_control.get_circle_x(), 1e-6);
+	high_level_control.FollowCircle(msg);
+	ASSERT_EQ(-10, high_level_control.get_circle_x());
+}
+
+TEST(HlcPropagateCircle, OdometryCase) {
+	HighLevelControl high_level_control;
+	std::vector<float> ranges(720, 5);
+	robot::circle_detect_msg msg;
+	msg.circle_x = 0;
+	msg.circle_y = 1;
+	high_level_control.ChooseCircle(msg, ranges);
+
+	// Half a metre forward brings the circle half a metre closer
+	Pose2D pose;
+	pose.x_ = 0.5;
+	pose.y_ = 0;
+	pose.theta_ = 0;
+	high_level_control.PropagateCircle(pose);
+	ASSERT_NEAR(0, high_level_control.get_circle_x(), 1e-6);
+	ASSERT_NEAR(0.5, high_level_control.get_circle_y(), 1e-6);
+
+	// Turning left in place puts it on the right. The LRF sits 0.15 m in
+	// front of the centre the robot turns around, so it swings 0.15 m to
+	// the left and the circle ends up 0.15 m behind it
+	pose.theta_ = M_PI / 2;
+	high_level_control.PropagateCircle(pose);
+	ASSERT_NEAR(0.65, high_level_control.get_circle_x(), 1e-6);
+	ASSERT_NEAR(-0.15, high_level_control.get_circle_y(), 1e-6);
+
+	// Turning back in place brings it in front again
+	pose.theta_ = 0;
+	high_level_control.PropagateCircle(pose);
+	ASSERT_NEAR(0, high_level_control.get_circle_x(), 1e-6);
+	ASSERT_NEAR(0.5, high_level_control.get_circle_y(), 1e-6);
+
+	// No circle stays no circle
+	msg.circle_x = -10;
+	msg.circle_y = -10;
+	high_level_control.ChooseCircle(msg, ranges);
+	pose.x_ = 1;
+	high_level_control.PropagateCircle(pose);
+	ASSERT_EQ(-10, high_level_control.get_circle_x());
+}
+
 int main(int argc, char** argv) {
 	testing::InitGoogleTest(&argc, argv);
 	ros::init(argc, argv, "HLC_unit_test");
@@ -0,0 +1,141 @@
+/**
+ * @file ROBOT_occupancy_grid_test.cpp
+ * @brief This file contains the unit tests for the map the robot builds of
+ * the space it has seen
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "occupancy_grid.h"
+#include "pose_helpers.h"
+
+// A scan of 720 beams over the half plane in front, all of the same range
+std::vector<float> HalfCircleScan(float range) {
+	return std::vector<float>(720, range);
+}
+
+TEST(OccupancyGrid, MarksFreeAndOccupied) {
+	OccupancyGrid grid;
+	grid.SetParams(0.05, 4, 720, 0);
+	ASSERT_EQ(0, grid.TileCount());
+	ASSERT_EQ(CELL_UNKNOWN, grid.State(0.5, 0));
+
+	grid.Update(MakePose(0, 0, 0), HalfCircleScan(1.02), -M_PI / 2, M_PI / 720, 5);
+	ASSERT_EQ(CELL_FREE, grid.State(0.5, 0));
+	ASSERT_EQ(CELL_FREE, grid.State(0, 0.5));
+	ASSERT_EQ(CELL_OCCUPIED, grid.State(1.02, 0));
+	ASSERT_EQ(CELL_OCCUPIED, grid.State(0, -1.02));
+	// Behind the wall and behind the robot nothing was seen
+	ASSERT_EQ(CELL_UNKNOWN, grid.State(1.5, 0));
+	ASSERT_EQ(CELL_UNKNOWN, grid.State(-0.5, 0));
+
+	// The same scan seen from a turned robot marks the turned cells
+	grid.Clear();
+	grid.Update(MakePose(1, 1, M_PI / 2), HalfCircleScan(1.02), -M_PI / 2, M_PI / 720, 5);
+	ASSERT_EQ(CELL_FREE, grid.State(1, 1.5));
+	ASSERT_EQ(CELL_OCCUPIED, grid.State(1, 2.02));
+	ASSERT_EQ(CELL_UNKNOWN, grid.State(1, 0.5));
+}
+
+TEST(OccupancyGrid, LaserOffset) {
+	// The beams start at the laser range finder 0.15 m in front of the
+	// centre, so a wall seen from opposite headings lands in the same place
+	OccupancyGrid grid;
+	grid.SetParams(0.05, 4, 720, 0.15);
+	grid.Update(MakePose(0, 0, 0), HalfCircleScan(0.87), -M_PI / 2, M_PI / 720, 5);
+	ASSERT_EQ(CELL_OCCUPIED, grid.State(1.02, 0));
+	ASSERT_EQ(CELL_OCCUPIED, grid.State(0.765, 0.615));
+	ASSERT_EQ(CELL_FREE, grid.State(0.9, 0));
+
+	grid.Clear();
+	grid.Update(MakePose(2.04, 0, M_PI), HalfCircleScan(0.87), -M_PI / 2, M_PI / 720, 5);
+	ASSERT_EQ(CELL_OCCUPIED, grid.State(1.02, 0));
+	ASSERT_EQ(CELL_OCCUPIED, grid.State(1.275, 0.615));
+	ASSERT_EQ(CELL_FREE, grid.State(1.14, 0));
+}
+
+TEST(OccupancyGrid, BeamsWithoutReturn) {
+	OccupancyGrid grid;
+	grid.SetParams(0.05, 2, 720, 0);
+	// Beams at the maximum range only clear the cells up to max_range
+	grid.Update(MakePose(0, 0, 0), HalfCircleScan(5), -M_PI / 2, M_PI / 720, 5);
+	ASSERT_EQ(CELL_FREE, grid.State(1.9, 0));
+	ASSERT_NE(CELL_OCCUPIED, grid.State(2, 0));
+	ASSERT_EQ(CELL_UNKNOWN, grid.State(2.5, 0));
+}
+
+TEST(OccupancyGrid, TilesGrowOnDemand) {
+	OccupancyGrid grid;
+	grid.SetParams(0.05, 1, 720, 0);
+	grid.Update(MakePose(0, 0, 0), HalfCircleScan(0.5), -M_PI / 2, M_PI / 720, 5);
+	size_t tiles = grid.TileCount();
+	ASSERT_GT(tiles, 0);
+
+	// Seeing the same place again needs no new tiles, a new place does
+	grid.Update(MakePose(0, 0, 0), HalfCircleScan(0.5), -M_PI / 2, M_PI / 720, 5);
+	ASSERT_EQ(tiles, grid.TileCount());
+	grid.Update(MakePose(20, -20, 0), HalfCircleScan(0.5), -M_PI / 2, M_PI / 720, 5);
+	ASSERT_GT(grid.TileCount(), tiles);
+	ASSERT_EQ(CELL_FREE, grid.State(20.25, -20));
+}
+
+TEST(OccupancyGrid, BoundedBeams) {
+	OccupancyGrid grid;
+	// Only every 90th beam is put into the map
+	grid.SetParams(0.05, 4, 8, 0);
+	grid.Update(MakePose(0, 0, 0), HalfCircleScan(3), -M_PI / 2, M_PI / 720, 5);
+	ASSERT_EQ(CELL_FREE, grid.State(2.5, 0));
+	// Far between two of those beams nothing was seen
+	double between = -M_PI / 2 + 405 * M_PI / 720;
+	ASSERT_EQ(CELL_UNKNOWN, grid.State(2.5 * std::cos(between), 2.5 * std::sin(between)));
+}
+
+TEST(OccupancyGrid, UnknownAlong) {
+	OccupancyGrid grid;
+	grid.SetParams(0.05, 4, 720, 0);
+	grid.Update(MakePose(0, 0, 0), HalfCircleScan(1.02), -M_PI / 2, M_PI / 720, 5);
+	// In front everything up to the wall is known
+	ASSERT_EQ(0, grid.UnknownAlong(0, 0, 0, 2));
+	// Behind the robot all of it is new
+	ASSERT_EQ(20, grid.UnknownAlong(0, 0, M_PI, 1));
+}
+
+TEST(OccupancyGrid, FindFrontiers) {
+	OccupancyGrid grid;
+	grid.SetParams(0.05, 2, 720, 0);
+	std::vector<Frontier> frontiers;
+	grid.FindFrontiers(1, frontiers);
+	ASSERT_TRUE(frontiers.empty());
+
+	// Looking into open space leaves a frontier where the beams end
+	grid.Update(MakePose(0, 0, 0), HalfCircleScan(5), -M_PI / 2, M_PI / 720, 5);
+	grid.FindFrontiers(5, frontiers);
+	ASSERT_FALSE(frontiers.empty());
+	bool ahead = false;
+	for (size_t i = 0; i < frontiers.size(); ++i) {
+		ASSERT_GE(frontiers[i].size_, 5);
+		double distance = std::hypot(frontiers[i].x_, frontiers[i].y_);
+		ahead = ahead || (distance > 1.8 && frontiers[i].x_ > 1);
+	}
+	ASSERT_TRUE(ahead);
+
+	// Walls all around the seen half leave frontiers only behind the robot
+	grid.Clear();
+	grid.Update(MakePose(0, 0, 0), HalfCircleScan(1.02), -M_PI / 2, M_PI / 720, 5);
+	grid.FindFrontiers(5, frontiers);
+	for (size_t i = 0; i < frontiers.size(); ++i) {
+		ASSERT_LT(frontiers[i].x_, 0.1);
+	}
+}
+
+int main(int argc, char** argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
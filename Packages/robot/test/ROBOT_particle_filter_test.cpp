@@ -0,0 +1,128 @@
+/**
+ * @file ROBOT_particle_filter_test.cpp
+ * @brief This file contains the unit tests for the localisation of the robot
+ * in a known map
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "likelihood_field.h"
+#include "particle_filter.h"
+#include "pose_helpers.h"
+
+const int width = 200;
+const int height = 150;
+const double resolution = 0.02;
+const double origin_x = -2;
+const double origin_y = -1.5;
+
+// A room of 4 x 3 metres with two boxes and a wall piece, so no two places
+// look the same
+std::vector<unsigned char> RoomMap() {
+	std::vector<unsigned char> occupied(width * height, 0);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			bool border = x == 0 || y == 0 || x == width - 1 || y == height - 1;
+			bool box = x >= 40 && x < 60 && y >= 30 && y < 50;
+			bool small_box = x >= 140 && x < 150 && y >= 100 && y < 110;
+			bool wall = x == 100 && y >= 90;
+			occupied[y * width + x] = border || box || small_box || wall;
+		}
+	}
+	return occupied;
+}
+
+// A scan of 720 beams over 240 degrees from a pose of the robot, with the
+// laser range finder 0.15 metres in front of its centre
+std::vector<float> RoomScan(const std::vector<unsigned char>& occupied, const Pose2D& pose) {
+	std::vector<float> ranges(720, 5);
+	double laser_x = pose.x_ + 0.15 * std::cos(pose.theta_);
+	double laser_y = pose.y_ + 0.15 * std::sin(pose.theta_);
+	for (int i = 0; i < 720; ++i) {
+		double angle = pose.theta_ - 2 * M_PI / 3 + i * 4 * M_PI / 3 / 720;
+		for (double range = 0; range < 5; range += 0.005) {
+			int x = static_cast<int>(std::floor((laser_x + range * std::cos(angle) - origin_x) / resolution));
+			int y = static_cast<int>(std::floor((laser_y + range * std::sin(angle) - origin_y) / resolution));
+			if (x < 0 || y < 0 || x >= width || y >= height || occupied[y * width + x]) {
+				ranges[i] = range;
+				break;
+			}
+		}
+	}
+	return ranges;
+}
+
+TEST(LikelihoodField, ExactDistances) {
+	std::vector<unsigned char> occupied = RoomMap();
+	LikelihoodField field;
+	ASSERT_FALSE(field.HasMap());
+	field.SetMap(occupied, width, height, resolution, origin_x, origin_y, 0.05);
+	ASSERT_TRUE(field.HasMap());
+
+	// Against the closest occupied cell found by trying all of them
+	for (int y = 3; y < height; y += 17) {
+		for (int x = 5; x < width; x += 23) {
+			double best = 1e9;
+			for (int oy = 0; oy < height; ++oy) {
+				for (int ox = 0; ox < width; ++ox) {
+					if (occupied[oy * width + ox]) {
+						best = std::min(best, std::hypot(ox - x, oy - y) * resolution);
+					}
+				}
+			}
+			ASSERT_NEAR(best, field.Distance(origin_x + (x + 0.5) * resolution,
+			                                 origin_y + (y + 0.5) * resolution), 1e-4);
+		}
+	}
+	ASSERT_EQ(0, field.Distance(-5, 0));
+
+	// A point on an obstacle is more likely than one away from it, and one
+	// outside the map is no better than a far one
+	float on_wall[2] = {-1.99f, 0}, far[2] = {0.5f, -0.5f}, outside[2] = {-7, 9};
+	float zero[2] = {0, 0};
+	ASSERT_GT(field.SumLogLikelihood(on_wall, zero, 1), field.SumLogLikelihood(far, zero, 1));
+	ASSERT_NEAR(field.SumLogLikelihood(far, zero + 1, 1),
+	            field.SumLogLikelihood(outside, outside + 1, 1), 1e-3);
+}
+
+TEST(ParticleFilter, GlobalLocalisation) {
+	std::vector<unsigned char> occupied = RoomMap();
+	ParticleFilter filter;
+	filter.SetParams(200, 20000, 60, 0.15);
+	filter.SetMap(occupied, width, height, resolution, origin_x, origin_y, 0.1);
+	filter.InitialiseGlobal();
+	ASSERT_EQ(20000, filter.ParticleCount());
+
+	// The robot drives along the room and turns a little, every scan is
+	// taken after 5 centimetres
+	Pose2D pose = MakePose(-1.2, -0.5, 0.3);
+	Pose2D motion = MakePose(0.05, 0, 0.02);
+	filter.Correct(RoomScan(occupied, pose), -2 * M_PI / 3, 4 * M_PI / 3 / 720, 5);
+	for (int step = 0; step < 25; ++step) {
+		double cos_theta = std::cos(pose.theta_), sin_theta = std::sin(pose.theta_);
+		pose = MakePose(pose.x_ + cos_theta * motion.x_, pose.y_ + sin_theta * motion.x_,
+		                pose.theta_ + motion.theta_);
+		filter.Predict(motion);
+		filter.Correct(RoomScan(occupied, pose), -2 * M_PI / 3, 4 * M_PI / 3 / 720, 5);
+	}
+
+	Pose2D estimate = filter.Estimate();
+	ASSERT_NEAR(pose.x_, estimate.x_, 0.05);
+	ASSERT_NEAR(pose.y_, estimate.y_, 0.05);
+	ASSERT_NEAR(0, NormaliseAngle(pose.theta_ - estimate.theta_), 0.05);
+	ASSERT_LT(filter.Spread(), 0.1);
+	// Once localised, KLD sampling needs far fewer particles
+	ASSERT_LT(filter.ParticleCount(), 1000);
+}
+
+int main(int argc, char** argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
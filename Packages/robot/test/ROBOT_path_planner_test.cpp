@@ -0,0 +1,108 @@
+/**
+ * @file ROBOT_path_planner_test.cpp
+ * @brief This file contains the unit tests for the planning of a path to a
+ * goal through the map the robot builds
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "occupancy_grid.h"
+#include "path_planner.h"
+#include "pose_helpers.h"
+
+// A scan of 720 beams over the half plane in front that sees a wall 1 metre
+// ahead, 1.2 metres wide, and nothing elsewhere
+std::vector<float> WallScan() {
+	std::vector<float> ranges(720, 10);
+	for (int i = 0; i < 720; ++i) {
+		double angle = -M_PI / 2 + i * M_PI / 720;
+		if (std::fabs(std::tan(angle)) < 0.6) {
+			ranges[i] = 1 / std::cos(angle);
+		}
+	}
+	return ranges;
+}
+
+double PathLength(double x, double y, const std::vector<double>& path_x,
+                  const std::vector<double>& path_y) {
+	double length = 0;
+	for (size_t i = 0; i < path_x.size(); ++i) {
+		length += std::hypot(path_x[i] - x, path_y[i] - y);
+		x = path_x[i];
+		y = path_y[i];
+	}
+	return length;
+}
+
+TEST(PathPlanner, StraightInFreeSpace) {
+	OccupancyGrid map;
+	map.SetParams(0.05, 4, 720, 0);
+	PathPlanner planner;
+	planner.SetParams(0.23, 0.25);
+	std::vector<double> path_x, path_y;
+	ASSERT_FALSE(planner.Plan(map, 0, 0, path_x, path_y));
+
+	planner.SetGoal(2, 0);
+	ASSERT_TRUE(planner.Plan(map, 0, 0, path_x, path_y));
+	ASSERT_EQ(2, path_x.back());
+	ASSERT_EQ(0, path_y.back());
+	ASSERT_NEAR(2, PathLength(0, 0, path_x, path_y), 0.1);
+	for (size_t i = 0; i < path_y.size(); ++i) {
+		ASSERT_NEAR(0, path_y[i], 0.05);
+	}
+}
+
+TEST(PathPlanner, ReplansAroundNewWall) {
+	OccupancyGrid map;
+	map.SetParams(0.05, 4, 720, 0);
+	PathPlanner planner;
+	planner.SetParams(0.23, 0.25);
+	planner.SetGoal(2, 0);
+	std::vector<double> path_x, path_y;
+	ASSERT_TRUE(planner.Plan(map, 0, 0, path_x, path_y));
+
+	// A scan reveals a wall across the straight path. The path goes around
+	// it and keeps the inflation radius to it
+	map.Update(MakePose(0.05, 0, 0), WallScan(), -M_PI / 2, M_PI / 720, 5);
+	ASSERT_TRUE(planner.Plan(map, 0.05, 0, path_x, path_y));
+	double length = PathLength(0.05, 0, path_x, path_y);
+	ASSERT_GT(length, 2.2);
+	for (size_t i = 0; i + 1 < path_x.size(); ++i) {
+		if (std::fabs(path_x[i] - 1.05) < 0.23) {
+			ASSERT_GT(std::fabs(path_y[i]), 0.6 + 0.23 - 0.05);
+		}
+	}
+
+	// The repaired search finds as short a path as a new one
+	PathPlanner fresh;
+	fresh.SetParams(0.23, 0.25);
+	fresh.SetGoal(2, 0);
+	std::vector<double> fresh_x, fresh_y;
+	ASSERT_TRUE(fresh.Plan(map, 0.05, 0, fresh_x, fresh_y));
+	ASSERT_NEAR(PathLength(0.05, 0, fresh_x, fresh_y), length, 0.05);
+}
+
+TEST(PathPlanner, EnclosedGoal) {
+	// A ring of obstacles around the goal leaves no way in
+	OccupancyGrid map;
+	map.SetParams(0.05, 4, 720, 0);
+	map.Update(MakePose(2, 0, 0), std::vector<float>(720, 0.7), -M_PI, 2 * M_PI / 720, 5);
+	PathPlanner planner;
+	planner.SetParams(0.23, 0.25);
+	planner.SetGoal(2, 0);
+	std::vector<double> path_x, path_y;
+	ASSERT_FALSE(planner.Plan(map, 0, 0, path_x, path_y));
+	ASSERT_TRUE(path_x.empty());
+}
+
+int main(int argc, char** argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
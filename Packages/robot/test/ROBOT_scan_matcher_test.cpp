@@ -0,0 +1,113 @@
+/**
+ * @file ROBOT_scan_matcher_test.cpp
+ * @brief This file contains the unit tests for the estimation of the motion
+ * of the robot from two consecutive laser scans
+ *
+ * @author Atabak Hafeez [atabakhafeez]
+ * @author Maria Ficiu [MariaFiciu]
+ * @author Rubin Deliallisi [rdeliallisi]
+ * @author Siddharth Shukla [thunderboltsid]
+ * @bug No known bugs.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "scan_matcher.h"
+#include "pose_helpers.h"
+
+const int beams = 720;
+const double angle_min = -2 * M_PI / 3;
+const double angle_increment = 4 * M_PI / 3 / beams;
+
+// A scan of 720 beams over 240 degrees taken from a pose in a room from
+// (-2, -1.5) to (3, 2) with a box from (1, 0.5) to (1.5, 1) in it
+std::vector<float> RoomScan(const Pose2D& pose) {
+	const double walls[8][4] = {
+		{-2, -1.5, 3, -1.5}, {3, -1.5, 3, 2}, {3, 2, -2, 2}, {-2, 2, -2, -1.5},
+		{1, 0.5, 1.5, 0.5}, {1.5, 0.5, 1.5, 1}, {1.5, 1, 1, 1}, {1, 1, 1, 0.5}
+	};
+	std::vector<float> ranges(beams);
+	for (int i = 0; i < beams; ++i) {
+		double angle = pose.theta_ + angle_min + i * angle_increment;
+		double dx = std::cos(angle), dy = std::sin(angle);
+		double range = std::numeric_limits<double>::infinity();
+		for (int w = 0; w < 8; ++w) {
+			double ex = walls[w][2] - walls[w][0], ey = walls[w][3] - walls[w][1];
+			double det = ex * dy - dx * ey;
+			if (std::fabs(det) < 1e-12) {
+				continue;
+			}
+			double ox = walls[w][0] - pose.x_, oy = walls[w][1] - pose.y_;
+			double t = (ex * oy - ox * ey) / det;
+			double s = (dx * oy - ox * dy) / det;
+			if (t > 0 && s >= 0 && s <= 1) {
+				range = std::min(range, t);
+			}
+		}
+		ranges[i] = static_cast<float>(range);
+	}
+	return ranges;
+}
+
+TEST(ScanMatcher, RecoversMotion) {
+	ScanMatcher matcher;
+	matcher.SetParams(20, 0.3);
+	ASSERT_FALSE(matcher.HasReference());
+
+	Pose2D start = MakePose(0, 0, 0.1);
+	matcher.SetReference(RoomScan(start), angle_min, angle_increment, 0.02, 30);
+	ASSERT_TRUE(matcher.HasReference());
+
+	// The robot moves 10 cm forward and a bit to the left while turning 3
+	// degrees, the match starts from no motion at all
+	Pose2D expected = MakePose(0.1, 0.03, 3 * M_PI / 180);
+	double cos_theta = std::cos(start.theta_), sin_theta = std::sin(start.theta_);
+	Pose2D end = MakePose(start.x_ + cos_theta * expected.x_ - sin_theta * expected.y_,
+	                      start.y_ + sin_theta * expected.x_ + cos_theta * expected.y_,
+	                      start.theta_ + expected.theta_);
+	Pose2D motion = MakePose(0, 0, 0);
+	ASSERT_TRUE(matcher.Match(RoomScan(end), angle_min, angle_increment, 0.02, 30,
+	                          MakePose(0, 0, 0), motion));
+	ASSERT_NEAR(expected.x_, motion.x_, 0.01);
+	ASSERT_NEAR(expected.y_, motion.y_, 0.01);
+	ASSERT_NEAR(expected.theta_, motion.theta_, 0.5 * M_PI / 180);
+
+	// The same scan again means no motion
+	matcher.SetReference(RoomScan(end), angle_min, angle_increment, 0.02, 30);
+	ASSERT_TRUE(matcher.Match(RoomScan(end), angle_min, angle_increment, 0.02, 30,
+	                          expected, motion));
+	ASSERT_NEAR(0, motion.x_, 0.01);
+	ASSERT_NEAR(0, motion.y_, 0.01);
+	ASSERT_NEAR(0, motion.theta_, 0.5 * M_PI / 180);
+}
+
+TEST(ScanMatcher, TooFewPoints) {
+	ScanMatcher matcher;
+	matcher.SetParams(20, 0.3);
+	std::vector<float> reference = RoomScan(MakePose(0, 0, 0));
+	matcher.SetReference(reference, angle_min, angle_increment, 0.02, 30);
+
+	// Only a handful of beams see anything
+	std::vector<float> sparse(beams, std::numeric_limits<float>::infinity());
+	for (int i = 0; i < 10; ++i) {
+		sparse[300 + i] = reference[300 + i];
+	}
+	Pose2D motion = MakePose(1, 2, 3);
+	ASSERT_FALSE(matcher.Match(sparse, angle_min, angle_increment, 0.02, 30,
+	                           MakePose(0, 0, 0), motion));
+	ASSERT_EQ(1, motion.x_);
+
+	// A reference that saw nothing can not be matched against
+	matcher.SetReference(sparse, angle_min, angle_increment, 0.02, 30);
+	ASSERT_FALSE(matcher.HasReference());
+	ASSERT_FALSE(matcher.Match(reference, angle_min, angle_increment, 0.02, 30,
+	                           MakePose(0, 0, 0), motion));
+}
+
+int main(int argc, char** argv) {
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
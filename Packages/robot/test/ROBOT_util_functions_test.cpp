@@ -61,6 +61,62 @@ TEST(GetMinTest, WrongLimits) {
 	ASSERT_DOUBLE_EQ(0, GetMin(ranges, 5, 3));
 }
 
+TEST(PursuitCurvatureTest, Arcs) {
+	// Straight ahead needs no turn
+	ASSERT_DOUBLE_EQ(0, PursuitCurvature(1, 0));
+	// A point 1 m to the left and 1 m ahead lies on a circle of radius 1
+	ASSERT_DOUBLE_EQ(1, PursuitCurvature(1, 1));
+	ASSERT_DOUBLE_EQ(-1, PursuitCurvature(1, -1));
+	ASSERT_DOUBLE_EQ(0, PursuitCurvature(0, 0));
+}
+
+TEST(ArcVelocitiesTest, Arcs) {
+	double linear_velocity = 0.4, angular_velocity;
+	ArcVelocities(1, 0, 1, linear_velocity, angular_velocity);
+	ASSERT_DOUBLE_EQ(0.4, linear_velocity);
+	ASSERT_DOUBLE_EQ(0, angular_velocity);
+
+	// A radius of 0.2 m would need 2 rad/s at full speed
+	ArcVelocities(0.2, 0.2, 1, linear_velocity, angular_velocity);
+	ASSERT_DOUBLE_EQ(0.2, linear_velocity);
+	ASSERT_DOUBLE_EQ(1, angular_velocity);
+
+	// Behind the robot it turns in place
+	linear_velocity = 0.4;
+	ArcVelocities(-1, -0.1, 1, linear_velocity, angular_velocity);
+	ASSERT_DOUBLE_EQ(0, linear_velocity);
+	ASSERT_DOUBLE_EQ(-1, angular_velocity);
+}
+
+TEST(ApproachVelocityTest, Limits) {
+	// Braking at 2 m/s^2 from 1 m/s takes 0.25 m
+	ASSERT_NEAR(1, ApproachVelocity(0.25, 0.1, 5, 2), 1e-9);
+	ASSERT_DOUBLE_EQ(5, ApproachVelocity(100, 0.1, 5, 2));
+	ASSERT_DOUBLE_EQ(0.1, ApproachVelocity(0, 0.1, 5, 2));
+	ASSERT_DOUBLE_EQ(0.1, ApproachVelocity(-1, 0.1, 5, 2));
+}
+
+TEST(CorridorFreeDistanceTest, Points) {
+	std::vector<float> ranges(720, 5);
+	std::vector<float> x, y;
+	ScanToPoints(ranges, x, y);
+	ASSERT_EQ(720, x.size());
+	// The beam in the middle looks straight ahead
+	ASSERT_NEAR(0, x[360], 1e-5);
+	ASSERT_NEAR(5, y[360], 1e-5);
+
+	// Nothing closer than 5 m leaves the way to a goal 1 m ahead free
+	ASSERT_NEAR(1, CorridorFreeDistance(x, y, 0, 1, 0.2), 1e-6);
+
+	// A point 0.5 m ahead and 0.1 m to the side is in the way
+	x.push_back(0.1);
+	y.push_back(0.5);
+	ASSERT_NEAR(0.5, CorridorFreeDistance(x, y, 0, 1, 0.2), 1e-6);
+	// but not of a narrower robot or of a goal to the left
+	ASSERT_NEAR(1, CorridorFreeDistance(x, y, 0, 1, 0.05), 1e-6);
+	ASSERT_NEAR(1, CorridorFreeDistance(x, y, -1, 0, 0.2), 1e-6);
+}
+
 int main(int argc, char** argv) {
 	testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();